@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cwchar>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "uevr/API.hpp"
+
+#include "ConsoleIndex.hpp"
+
+// A named list of cvar values, one "name=value" or "name value" per line, # and ; start comments.
+// The name is the file's stem, so presets/vr.txt is the preset "vr".
+struct CVarPreset {
+    struct Value {
+        std::wstring name;
+        std::wstring value;
+    };
+
+    std::wstring name{};
+    std::vector<Value> values{};
+
+    static std::optional<CVarPreset> load(const std::filesystem::path& path) {
+        std::wifstream file{path};
+
+        if (!file) {
+            return std::nullopt;
+        }
+
+        CVarPreset out{};
+        out.name = path.stem().wstring();
+
+        std::wstring line{};
+
+        while (std::getline(file, line)) {
+            const auto trim = [](std::wstring_view s) {
+                const auto first = s.find_first_not_of(L" \t\r");
+
+                if (first == std::wstring_view::npos) {
+                    return std::wstring_view{};
+                }
+
+                return s.substr(first, s.find_last_not_of(L" \t\r") - first + 1);
+            };
+
+            auto view = trim(line);
+
+            if (view.empty() || view[0] == L'#' || view[0] == L';') {
+                continue;
+            }
+
+            auto split = view.find(L'=');
+
+            if (split == std::wstring_view::npos) {
+                split = view.find_first_of(L" \t");
+            }
+
+            if (split == std::wstring_view::npos) {
+                continue;
+            }
+
+            const auto name = trim(view.substr(0, split));
+            const auto value = trim(view.substr(split + 1));
+
+            if (name.empty() || value.empty()) {
+                continue;
+            }
+
+            out.values.push_back(Value{std::wstring{name}, std::wstring{value}});
+        }
+
+        return out;
+    }
+
+    bool save(const std::filesystem::path& path) const {
+        std::error_code ec{};
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+        std::wofstream file{path};
+
+        if (!file) {
+            return false;
+        }
+
+        for (const auto& value : values) {
+            file << value.name << L'=' << value.value << L'\n';
+        }
+
+        return (bool)file;
+    }
+
+    // Every *.txt in dir, sorted by name
+    static std::vector<CVarPreset> load_all(const std::filesystem::path& dir) {
+        std::vector<CVarPreset> out{};
+        std::error_code ec{};
+
+        for (const auto& file : std::filesystem::directory_iterator{dir, ec}) {
+            if (!file.is_regular_file() || file.path().extension() != L".txt") {
+                continue;
+            }
+
+            if (auto preset = load(file.path()); preset) {
+                out.push_back(std::move(*preset));
+            }
+        }
+
+        std::sort(out.begin(), out.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+        return out;
+    }
+};
+
+// Applies a preset as the difference to the current cvar values and puts the old values back on restore().
+// The console API can't tell what type a cvar is, so every value is compared the way the engine stores it:
+// as the get_int() and get_float() pair read back after the write. An int cvar set to "0.5" reads back
+// as 0 and is reported as not matching the preset, a value that reads back the same as before it was
+// written (string cvars) is reported as one that can't be restored.
+// Game thread only, at a point where the engine isn't reading the cvars (see CVarBatch).
+class CVarPresetApplier {
+public:
+    struct Stats {
+        uint32_t written{0};
+        uint32_t unchanged{0};    // already at the preset's value
+        uint32_t missing{0};      // no such cvar
+        uint32_t mismatched{0};   // reads back as something other than the preset's value
+        uint32_t unrestorable{0}; // written but can't be read back, so it stays at the preset's value
+        uint32_t restored{0};
+        uint32_t kept{0};         // changed by someone else while the preset was applied, left alone
+    };
+
+    // What the engine hands back for a cvar, both ways since the type isn't known
+    struct Reading {
+        int32_t i{0};
+        float f{0.0f};
+
+        static Reading of(uevr::API::IConsoleVariable* var) {
+            return Reading{var->get_int(), var->get_float()};
+        }
+
+        bool operator==(const Reading& other) const = default;
+    };
+
+    bool is_applied() const { return m_applied; }
+    const Stats& get_stats() const { return m_stats; }
+
+    // Stats are for this application only
+    void apply(const CVarPreset& preset, const ConsoleIndex& index) {
+        if (m_applied) {
+            restore();
+        }
+
+        m_stats = {};
+        m_originals.clear();
+        m_originals.reserve(preset.values.size());
+
+        for (const auto& entry : preset.values) {
+            const auto var = index.find_variable(entry.name);
+
+            if (var == nullptr) {
+                ++m_stats.missing;
+                continue;
+            }
+
+            const auto target = parse(entry.value);
+            const auto before = Reading::of(var);
+
+            // Exact for float cvars and for whole numbers on int cvars, anything else goes through the write
+            if (target && before.f == *target && before.i == (int32_t)*target) {
+                ++m_stats.unchanged;
+                continue;
+            }
+
+            var->set(entry.value);
+
+            const auto after = Reading::of(var);
+
+            if (target && after.f != *target) {
+                ++m_stats.mismatched;
+                uevr::API::get()->log_warn("Preset value %ls=%ls reads back as %ls", entry.name.c_str(), entry.value.c_str(), format(after).c_str());
+            }
+
+            if (after == before) {
+                if (target) {
+                    ++m_stats.unchanged;
+                } else {
+                    ++m_stats.written;
+                    ++m_stats.unrestorable;
+                    uevr::API::get()->log_warn("Preset value %ls=%ls can't be read back, it won't be restored", entry.name.c_str(), entry.value.c_str());
+                }
+
+                continue;
+            }
+
+            m_originals.push_back(Original{var, entry.name, before, after});
+            ++m_stats.written;
+        }
+
+        m_applied = true;
+    }
+
+    // Puts back every value apply() changed, last write first
+    void restore() {
+        if (!m_applied) {
+            return;
+        }
+
+        for (auto it = m_originals.rbegin(); it != m_originals.rend(); ++it) {
+            if (Reading::of(it->var) != it->applied) {
+                ++m_stats.kept;
+                continue;
+            }
+
+            it->var->set(format(it->original));
+
+            if (Reading::of(it->var) != it->original) {
+                uevr::API::get()->log_warn("Couldn't restore %ls to %ls", it->name.c_str(), format(it->original).c_str());
+                continue;
+            }
+
+            ++m_stats.restored;
+        }
+
+        m_originals.clear();
+        m_applied = false;
+    }
+
+    static std::optional<float> parse(const std::wstring& value) {
+        try {
+            size_t end = 0;
+            const auto out = std::stof(value, &end);
+            return end == value.size() ? std::optional<float>{out} : std::nullopt;
+        } catch (...) {
+            return std::nullopt;
+        }
+    }
+
+    // Whole numbers without a fraction, the way they'd be typed into the console,
+    // anything else with enough digits to parse back to the same float
+    static std::wstring format(const Reading& reading) {
+        if ((float)reading.i == reading.f) {
+            return std::to_wstring(reading.i);
+        }
+
+        wchar_t buffer[32]{};
+        std::swprintf(buffer, std::size(buffer), L"%.9g", reading.f);
+        return buffer;
+    }
+
+private:
+    struct Original {
+        uevr::API::IConsoleVariable* var{nullptr};
+        std::wstring name{};
+        Reading original{};
+        Reading applied{};
+    };
+
+    std::vector<Original> m_originals{};
+    Stats m_stats{};
+    bool m_applied{false};
+};
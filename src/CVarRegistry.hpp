@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "uevr/API.hpp"
+
+#include "CVarShadow.hpp"
+
+// The cvars the plugin uses, declared once and looked up together as soon as the console manager exists.
+// Until then the lookups back off exponentially in calls to resolve(), once everything required was found
+// resolve() is a single atomic load. The shadows are the typed handles, the batch flushes their writes.
+class CVarRegistry {
+public:
+    struct Binding {
+        const wchar_t* name{nullptr};
+        CVarShadowBase* shadow{nullptr};
+        bool required{true};
+    };
+
+    struct Stats {
+        uint32_t attempts{0};
+        uint32_t skipped{0}; // resolve() calls that waited out the backoff
+        uint32_t missing_optional{0};
+    };
+
+    static constexpr uint32_t MAX_BACKOFF = 64; // calls, under a second at headset frame rates
+
+    CVarRegistry(std::initializer_list<Binding> bindings)
+        : m_bindings{bindings}
+    {
+    }
+
+    // Game thread only, the result can be checked from anywhere with is_resolved()
+    bool resolve() {
+        if (m_resolved.load(std::memory_order_relaxed)) {
+            return true;
+        }
+
+        if (m_wait > 0) {
+            --m_wait;
+            ++m_stats.skipped;
+            return false;
+        }
+
+        ++m_stats.attempts;
+
+        if (!try_resolve()) {
+            m_backoff = std::clamp(m_backoff * 2, 1u, MAX_BACKOFF);
+            m_wait = m_backoff;
+            return false;
+        }
+
+        // Optional cvars that still aren't there now stay unbound, their shadows just keep the values
+        for (const auto& binding : m_bindings) {
+            if (!binding.shadow->is_bound()) {
+                ++m_stats.missing_optional;
+                uevr::API::get()->log_warn("Optional cvar %ls not found", binding.name);
+            }
+        }
+
+        m_resolved.store(true, std::memory_order_release);
+        return true;
+    }
+
+    bool is_resolved() const { return m_resolved.load(std::memory_order_acquire); }
+
+    CVarBatch& get_batch() { return m_batch; }
+    const CVarBatch& get_batch() const { return m_batch; }
+    const Stats& get_stats() const { return m_stats; }
+
+private:
+    // Looks up whatever isn't bound yet, true once every required cvar is
+    bool try_resolve() {
+        const auto console = uevr::API::get()->get_console_manager();
+
+        if (console == nullptr) {
+            return false;
+        }
+
+        bool complete = true;
+
+        for (const auto& binding : m_bindings) {
+            if (binding.shadow->is_bound()) {
+                continue;
+            }
+
+            if (const auto var = console->find_variable(binding.name); var != nullptr) {
+                binding.shadow->bind(var);
+                m_batch.add(*binding.shadow);
+            } else if (binding.required) {
+                complete = false;
+            }
+        }
+
+        return complete;
+    }
+
+    std::vector<Binding> m_bindings{};
+    CVarBatch m_batch{};
+    Stats m_stats{};
+    uint32_t m_backoff{0};
+    uint32_t m_wait{0};
+    std::atomic<bool> m_resolved{false};
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "uevr/API.hpp"
+
+class CVarBatch;
+
+class CVarShadowBase {
+public:
+    virtual ~CVarShadowBase() = default;
+
+    virtual void bind(uevr::API::IConsoleVariable* var) = 0;
+    virtual bool is_bound() const = 0;
+
+protected:
+    friend class CVarBatch;
+
+    virtual bool flush() = 0; // true if it wrote to the cvar
+    virtual void refresh() = 0;
+};
+
+// Game thread side copy of a console variable.
+// get() never calls into UEVR, set() only queues the value, and the queued value
+// reaches the cvar the next time the batch it was added to is flushed.
+// An enforced shadow also reads the cvar back on every flush and writes our value again if anything
+// else changed it, which costs one get_int/get_float per frame instead of formatting and setting it.
+template <typename T>
+class CVarShadow final : public CVarShadowBase {
+public:
+    static_assert(std::is_same_v<T, int> || std::is_same_v<T, float>, "cvars are read as int or float");
+
+    struct Stats {
+        uint64_t queued{0};
+        uint64_t avoided{0}; // set() calls with the value the cvar already had or was about to get
+        uint64_t written{0};
+        uint64_t corrected{0}; // writes because something else changed an enforced cvar
+    };
+
+    void bind(uevr::API::IConsoleVariable* var) override {
+        m_var = var;
+        m_pending.reset();
+        refresh();
+    }
+
+    bool is_bound() const override { return m_var != nullptr; }
+
+    void set_enforced(bool enforced) { m_enforced = enforced; }
+    bool is_enforced() const { return m_enforced; }
+
+    // The value the cvar will have after the next flush
+    T get() const { return m_pending ? *m_pending : m_value; }
+
+    // Returns true if this changes the value
+    bool set(T value) {
+        if (value == get()) {
+            ++m_stats.avoided;
+            return false;
+        }
+
+        // Setting it back before the flush cancels the write
+        if (m_pending && value == m_value) {
+            m_pending.reset();
+            ++m_stats.avoided;
+            return true;
+        }
+
+        m_pending = value;
+        ++m_stats.queued;
+        return true;
+    }
+
+    const Stats& get_stats() const { return m_stats; }
+
+private:
+    bool flush() override {
+        if (m_var == nullptr) {
+            return false;
+        }
+
+        if (!m_pending) {
+            if (!m_enforced || read() == m_readback) {
+                return false;
+            }
+
+            m_pending = m_value;
+            ++m_stats.corrected;
+        }
+
+        m_var->set(*m_pending);
+        m_value = *m_pending;
+        m_pending.reset();
+        ++m_stats.written;
+
+        // What the cvar made of it, floats don't always survive the trip through a string exactly
+        m_readback = read();
+        return true;
+    }
+
+    // Picks up changes made through the console, queued values still win.
+    // Enforced shadows already check on every flush and keep their own value.
+    void refresh() override {
+        if (m_var == nullptr || m_enforced) {
+            return;
+        }
+
+        m_value = read();
+        m_readback = m_value;
+    }
+
+    T read() const {
+        if constexpr (std::is_same_v<T, int>) {
+            return m_var->get_int();
+        } else {
+            return m_var->get_float();
+        }
+    }
+
+    uevr::API::IConsoleVariable* m_var{nullptr};
+    T m_value{};
+    T m_readback{};
+    std::optional<T> m_pending{};
+    bool m_enforced{false};
+    Stats m_stats{};
+};
+
+// Writes every queued cvar value in one pass, meant to be flushed once per frame on the game thread
+// at a point where the engine isn't using the cvars (it runs its own cvar sinks from the engine tick).
+class CVarBatch {
+public:
+    struct Stats {
+        uint64_t flushes{0};
+        uint64_t writes{0};
+        uint64_t refreshes{0};
+    };
+
+    void add(CVarShadowBase& shadow) {
+        m_shadows.push_back(&shadow);
+    }
+
+    // Every refresh_interval-th flush also re-reads the cvars, 0 never does
+    void set_refresh_interval(uint32_t interval) { m_refresh_interval = interval; }
+
+    // Returns how many cvars were written
+    uint32_t flush() {
+        ++m_stats.flushes;
+
+        uint32_t writes = 0;
+
+        const auto refresh = m_refresh_interval != 0 && m_stats.flushes % m_refresh_interval == 0;
+
+        for (auto shadow : m_shadows) {
+            if (shadow->flush()) {
+                ++writes;
+            } else if (refresh) {
+                shadow->refresh();
+            }
+        }
+
+        if (refresh) {
+            ++m_stats.refreshes;
+        }
+
+        m_stats.writes += writes;
+        return writes;
+    }
+
+    const Stats& get_stats() const { return m_stats; }
+
+private:
+    std::vector<CVarShadowBase*> m_shadows{};
+    uint32_t m_refresh_interval{300};
+    Stats m_stats{};
+};
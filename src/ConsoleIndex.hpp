@@ -0,0 +1,256 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cwctype>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "uevr/API.hpp"
+
+// Case insensitive index over every object in the console manager, for looking up many cvars at once
+// (preset files) without going through the engine's find for each one.
+// Names are hashed for exact lookups and kept sorted for prefix queries like "r.InGameUI.".
+// Lookups never allocate. Not thread safe, meant to be used from the game thread like the console itself.
+class ConsoleIndex {
+public:
+    struct Entry {
+        std::wstring key;  // lowercase
+        std::wstring name; // as registered
+        uevr::API::IConsoleObject* object{nullptr};
+    };
+
+    struct Stats {
+        uint32_t full_builds{0};
+        uint32_t incremental_builds{0};
+        uint32_t entries{0};
+        uint32_t bad_layouts{0}; // updates skipped because the allocation flags didn't look like a TBitArray
+    };
+
+    // get_console_objects points at the engine's TMap<FString, IConsoleObject*>, whose elements live in a
+    // TSparseArray: the element TArray, directly followed by a TBitArray of the slots in use.
+    // Freed slots are reused as free list links, so only slots with their bit set hold an object.
+    struct AllocationFlags {
+        uint32_t inline_data[4];   // TInlineAllocator<4>
+        uint32_t* secondary_data;  // used instead once there are more than 128 slots
+        int32_t num_bits;
+        int32_t max_bits;
+
+        bool is_valid(int32_t count) const {
+            return num_bits == count && max_bits >= num_bits && (num_bits <= 128 || secondary_data != nullptr);
+        }
+
+        bool is_allocated(int32_t index) const {
+            const auto bits = secondary_data != nullptr ? secondary_data : inline_data;
+            return (bits[index / 32] >> (index % 32)) & 1;
+        }
+    };
+
+    // Brings the index up to date with the console manager's object map.
+    // The map is walked slot by slot and compared with what was indexed last time: when objects were only
+    // added (appended or filling freed slots) they get merged in, anything else (a removal, a slot now holding
+    // a different object) rebuilds from scratch.
+    // Returns true if the index changed.
+    bool update(uevr::API::FConsoleManager* console) {
+        if (console == nullptr) {
+            return false;
+        }
+
+        const auto& objects = console->get_console_objects();
+        const auto count = (std::max)(objects.count, 0);
+        const auto& flags = *(const AllocationFlags*)(&objects + 1);
+
+        if (!flags.is_valid(count)) {
+            ++m_stats.bad_layouts;
+            m_fallback = console;
+            return false;
+        }
+
+        m_fallback = nullptr;
+
+        bool removed = (size_t)count < m_slots.size() && std::any_of(m_slots.begin() + count, m_slots.end(), [](auto o) { return o != nullptr; });
+        m_added.clear();
+
+        for (int32_t i = 0; i < count && !removed; ++i) {
+            const auto& element = objects.data[i];
+            const auto object = flags.is_allocated(i) && element.key != nullptr ? element.value : nullptr;
+            const auto indexed = (size_t)i < m_slots.size() ? m_slots[i] : nullptr;
+
+            if (object == indexed) {
+                continue;
+            }
+
+            if (indexed != nullptr) {
+                removed = true;
+                break;
+            }
+
+            m_added.push_back(i);
+        }
+
+        if (!removed && m_added.empty()) {
+            m_slots.resize(count);
+            return false;
+        }
+
+        const auto full = removed || m_slots.empty();
+
+        if (full) {
+            m_entries.clear();
+            m_lookup.clear();
+            m_slots.assign(count, nullptr);
+            m_added.clear();
+
+            for (int32_t i = 0; i < count; ++i) {
+                if (flags.is_allocated(i) && objects.data[i].key != nullptr && objects.data[i].value != nullptr) {
+                    m_added.push_back(i);
+                }
+            }
+        } else {
+            m_slots.resize(count);
+        }
+
+        const auto old_size = m_entries.size();
+
+        for (const auto i : m_added) {
+            const auto& element = objects.data[i];
+            m_slots[i] = element.value;
+
+            Entry entry{to_key(element.key), element.key, element.value};
+
+            if (!m_lookup.emplace(entry.key, element.value).second) {
+                continue;
+            }
+
+            m_entries.push_back(std::move(entry));
+        }
+
+        const auto by_key = [](const Entry& a, const Entry& b) { return a.key < b.key; };
+        std::sort(m_entries.begin() + old_size, m_entries.end(), by_key);
+        std::inplace_merge(m_entries.begin(), m_entries.begin() + old_size, m_entries.end(), by_key);
+
+        if (full) {
+            ++m_stats.full_builds;
+        } else {
+            ++m_stats.incremental_builds;
+        }
+
+        m_stats.entries = (uint32_t)m_entries.size();
+        return true;
+    }
+
+    uevr::API::IConsoleObject* find(std::wstring_view name) const {
+        const auto it = m_lookup.find(name);
+        return it != m_lookup.end() ? it->second : nullptr;
+    }
+
+    // Same as FConsoleManager::find_variable, nullptr for commands.
+    // Goes to the engine instead if the map couldn't be indexed.
+    uevr::API::IConsoleVariable* find_variable(std::wstring_view name) const {
+        if (m_fallback != nullptr) {
+            return m_fallback->find_variable(std::wstring{name});
+        }
+
+        const auto object = find(name);
+
+        if (object == nullptr || object->as_command() != nullptr) {
+            return nullptr;
+        }
+
+        return (uevr::API::IConsoleVariable*)object;
+    }
+
+    bool contains(std::wstring_view name) const {
+        return m_lookup.contains(name);
+    }
+
+    // out[i] is nullptr for names that don't exist, returns how many were found
+    size_t find_all(std::span<const std::wstring_view> names, std::span<uevr::API::IConsoleObject*> out) const {
+        size_t found = 0;
+
+        for (size_t i = 0; i < names.size() && i < out.size(); ++i) {
+            out[i] = find(names[i]);
+            found += out[i] != nullptr ? 1 : 0;
+        }
+
+        return found;
+    }
+
+    // Every entry whose name starts with prefix, sorted by name.
+    // Stays valid until the next update() that returns true.
+    std::span<const Entry> find_prefix(std::wstring_view prefix) const {
+        const auto begin = std::lower_bound(m_entries.begin(), m_entries.end(), prefix, [](const Entry& e, std::wstring_view p) {
+            return compare_lower(e.key, p) < 0;
+        });
+
+        auto end = begin;
+
+        while (end != m_entries.end() && end->key.size() >= prefix.size() && compare_lower(std::wstring_view{end->key}.substr(0, prefix.size()), prefix) == 0) {
+            ++end;
+        }
+
+        return {begin, end};
+    }
+
+    std::span<const Entry> get_entries() const { return m_entries; }
+    const Stats& get_stats() const { return m_stats; }
+
+    static std::wstring to_key(std::wstring_view name) {
+        std::wstring out{name};
+        std::transform(out.begin(), out.end(), out.begin(), [](wchar_t c) { return (wchar_t)std::towlower(c); });
+        return out;
+    }
+
+private:
+    // Compares a lowercase key against a name in any case
+    static int compare_lower(std::wstring_view key, std::wstring_view name) {
+        const auto n = (std::min)(key.size(), name.size());
+
+        for (size_t i = 0; i < n; ++i) {
+            const auto a = key[i];
+            const auto b = (wchar_t)std::towlower(name[i]);
+
+            if (a != b) {
+                return a < b ? -1 : 1;
+            }
+        }
+
+        return key.size() == name.size() ? 0 : (key.size() < name.size() ? -1 : 1);
+    }
+
+    // Keys are stored lowercase, names are looked up in whatever case they come in
+    struct Hash {
+        using is_transparent = void;
+
+        // FNV-1a over the lowercased UTF-16 code units
+        size_t operator()(std::wstring_view s) const {
+            uint64_t h = 0xcbf29ce484222325ull;
+
+            for (const auto c : s) {
+                h = (h ^ (uint64_t)(uint16_t)std::towlower(c)) * 0x100000001b3ull;
+            }
+
+            return (size_t)h;
+        }
+    };
+
+    struct Equal {
+        using is_transparent = void;
+
+        bool operator()(std::wstring_view a, std::wstring_view b) const {
+            return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](wchar_t x, wchar_t y) {
+                return std::towlower(x) == std::towlower(y);
+            });
+        }
+    };
+
+    std::vector<Entry> m_entries{};
+    std::unordered_map<std::wstring, uevr::API::IConsoleObject*, Hash, Equal> m_lookup{};
+    std::vector<uevr::API::IConsoleObject*> m_slots{}; // what each slot of the map held when it was indexed
+    std::vector<int32_t> m_added{};
+    uevr::API::FConsoleManager* m_fallback{nullptr}; // set while the allocation flags don't look right
+    Stats m_stats{};
+};
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// Side length of the coverage grid the UI alpha probe reports, one bit per cell
+constexpr uint32_t UI_COVERAGE_GRID = 8;
+static_assert(UI_COVERAGE_GRID * UI_COVERAGE_GRID == 64, "coverage mask is a uint64_t");
+
+constexpr uint32_t MAX_CLEAR_RECTS = 16;
+
+struct ClearRect {
+    int32_t left{0};
+    int32_t top{0};
+    int32_t right{0};
+    int32_t bottom{0};
+};
+
+// count == 0 means clear the whole target
+struct ClearRects {
+    uint32_t count{0};
+    std::array<ClearRect, MAX_CLEAR_RECTS> rects{};
+};
+
+// Accumulates the coverage masks probed from one texture and turns them into a short list of rects to clear.
+// The rects are only trusted once the coverage has stopped growing for a while, and they are padded by one
+// cell to absorb small movement. The probe lags a few frames behind, so they only describe the texture up to
+// get_frame(); whoever clears has to check nothing was drawn into it after that (see UIPresentWork).
+// The plugin only clears once per UI render target swap, so this saves part of a rare clear rather than
+// per-frame bandwidth.
+class DirtyRects {
+public:
+    struct Config {
+        uint32_t min_stable_samples{8};
+        uint32_t max_coverage_percent{75}; // above this a full clear is cheaper than the rects
+    };
+
+    void set_config(const Config& config) { m_config = config; }
+
+    void reset(const void* texture = nullptr) {
+        m_texture = texture;
+        m_mask = 0;
+        m_frame = 0;
+        m_samples = 0;
+        m_stable_samples = 0;
+    }
+
+    // Starts over whenever the probed texture changes, frame is the one the probe was queued in
+    void add(const void* texture, uint64_t mask, uint64_t frame) {
+        if (texture != m_texture) {
+            reset(texture);
+        }
+
+        const auto merged = m_mask | mask;
+        m_stable_samples = merged == m_mask && m_samples > 0 ? m_stable_samples + 1 : 0;
+        m_mask = merged;
+        m_frame = (std::max)(m_frame, frame);
+        ++m_samples;
+    }
+
+    bool is_trusted(const void* texture) const {
+        return texture != nullptr && texture == m_texture && m_stable_samples >= m_config.min_stable_samples;
+    }
+
+    // The probe never saw anything in texture for long enough, there's nothing to clear
+    bool is_empty(const void* texture) const {
+        return is_trusted(texture) && m_mask == 0;
+    }
+
+    // Rects for clearing texture, or a full clear if the coverage of that texture isn't known well enough
+    ClearRects build(const void* texture, uint32_t width, uint32_t height, uint32_t tile_size) const {
+        if (!is_trusted(texture) || width == 0 || height == 0) {
+            return {};
+        }
+
+        return build_rects(dilate(m_mask), width, height, tile_size, m_config.max_coverage_percent);
+    }
+
+    uint64_t get_mask() const { return m_mask; }
+    uint64_t get_frame() const { return m_frame; } // newest frame the probe has seen of the texture
+    uint32_t get_samples() const { return m_samples; }
+    uint32_t get_stable_samples() const { return m_stable_samples; }
+
+    static bool test(uint64_t mask, uint32_t x, uint32_t y) {
+        return (mask >> (y * UI_COVERAGE_GRID + x)) & 1;
+    }
+
+    // Grows the mask by one cell in every direction, including diagonals
+    static uint64_t dilate(uint64_t mask) {
+        constexpr uint64_t not_left_col = 0xFEFEFEFEFEFEFEFEull;
+        constexpr uint64_t not_right_col = 0x7F7F7F7F7F7F7F7Full;
+
+        const auto horizontal = mask | ((mask << 1) & not_left_col) | ((mask >> 1) & not_right_col);
+        return horizontal | (horizontal << UI_COVERAGE_GRID) | (horizontal >> UI_COVERAGE_GRID);
+    }
+
+    // Pixel range covered by grid cell c along an axis, matching how the probe assigns its
+    // tiles to cells (cell = tile * GRID / tiles), rounded out to whole tiles
+    static void get_cell_range(uint32_t c, uint32_t size, uint32_t tiles, uint32_t tile_size, int32_t& begin, int32_t& end) {
+        const auto first_tile = (c * tiles + UI_COVERAGE_GRID - 1) / UI_COVERAGE_GRID;
+        const auto last_tile = ((c + 1) * tiles + UI_COVERAGE_GRID - 1) / UI_COVERAGE_GRID;
+
+        begin = (int32_t)(std::min)(first_tile * tile_size, size);
+        end = (int32_t)(std::min)(last_tile * tile_size, size);
+    }
+
+    // Horizontal runs of set cells per row, merged downwards with identical runs in the row below.
+    // Falls back to a full clear (count 0) when there are too many rects or they cover most of the target.
+    // tile_size is the probe's pixels per thread group, the grid is laid over whole tiles.
+    static ClearRects build_rects(uint64_t mask, uint32_t width, uint32_t height, uint32_t tile_size, uint32_t max_coverage_percent) {
+        ClearRects out{};
+        const auto tiles_x = (width + tile_size - 1) / tile_size;
+        const auto tiles_y = (height + tile_size - 1) / tile_size;
+
+        // Nothing seen at all is more likely a probe problem than a texture that was never drawn into
+        if (mask == 0) {
+            return out;
+        }
+
+        struct Run {
+            uint32_t x0, x1, y0, y1; // cells, half open
+        };
+
+        std::array<Run, UI_COVERAGE_GRID * UI_COVERAGE_GRID / 2> runs{};
+        uint32_t num_runs = 0;
+        uint32_t open_begin = 0; // runs from here on may still grow into the current row
+
+        for (uint32_t y = 0; y < UI_COVERAGE_GRID; ++y) {
+            const auto row_open_end = num_runs;
+
+            for (uint32_t x = 0; x < UI_COVERAGE_GRID;) {
+                if (!test(mask, x, y)) {
+                    ++x;
+                    continue;
+                }
+
+                const auto x0 = x;
+
+                while (x < UI_COVERAGE_GRID && test(mask, x, y)) {
+                    ++x;
+                }
+
+                bool extended = false;
+
+                for (auto i = open_begin; i < row_open_end; ++i) {
+                    auto& run = runs[i];
+
+                    if (run.y1 == y && run.x0 == x0 && run.x1 == x) {
+                        run.y1 = y + 1;
+                        extended = true;
+                        break;
+                    }
+                }
+
+                if (!extended) {
+                    runs[num_runs++] = Run{x0, x, y, y + 1};
+                }
+            }
+
+            // Anything that didn't reach this row is finished
+            while (open_begin < row_open_end && runs[open_begin].y1 <= y) {
+                ++open_begin;
+            }
+        }
+
+        if (num_runs > MAX_CLEAR_RECTS) {
+            return out;
+        }
+
+        uint64_t covered = 0;
+        uint32_t count = 0;
+
+        for (uint32_t i = 0; i < num_runs; ++i) {
+            const auto& run = runs[i];
+            auto& rect = out.rects[count];
+            int32_t unused{};
+
+            get_cell_range(run.x0, width, tiles_x, tile_size, rect.left, unused);
+            get_cell_range(run.x1 - 1, width, tiles_x, tile_size, unused, rect.right);
+            get_cell_range(run.y0, height, tiles_y, tile_size, rect.top, unused);
+            get_cell_range(run.y1 - 1, height, tiles_y, tile_size, unused, rect.bottom);
+
+            // Targets with fewer tiles than grid cells on an axis leave some cells without any pixels
+            if (rect.right <= rect.left || rect.bottom <= rect.top) {
+                rect = {};
+                continue;
+            }
+
+            covered += (uint64_t)(rect.right - rect.left) * (uint64_t)(rect.bottom - rect.top);
+            ++count;
+        }
+
+        if (count == 0 || covered * 100 > (uint64_t)width * height * max_coverage_percent) {
+            return {};
+        }
+
+        out.count = count;
+        return out;
+    }
+
+private:
+    Config m_config{};
+    const void* m_texture{nullptr};
+    uint64_t m_mask{0};
+    uint64_t m_frame{0};
+    uint32_t m_samples{0};
+    uint32_t m_stable_samples{0};
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "FrameTimeController.hpp"
+
+// Scales the resolution written to GSystemResolution between user bounds, based on present to present
+// intervals. The frame time decisions are FrameTimeController's, this only adds
+// the bounds and turns the scale into sizes the engine's render target pool can allocate without odd leftovers.
+// Deterministic like the controller, a recorded trace replayed through add_sample() gives the same sizes.
+class DynamicResolution {
+public:
+    struct Config {
+        bool enabled{false};
+        float min_scale{0.7f};  // of the HMD's per eye resolution
+        float max_scale{1.0f};
+        uint32_t granularity{8}; // per eye, both axes
+        FrameTimeController::Config controller{};
+    };
+
+    struct Size {
+        uint32_t width{0};  // both eyes side by side, like GSystemResolution
+        uint32_t height{0};
+
+        bool operator==(const Size&) const = default;
+    };
+
+    void set_config(const Config& config) {
+        m_config = config;
+        m_config.granularity = (std::max)(m_config.granularity, 1u);
+
+        auto controller = m_config.controller;
+        controller.min_scale = m_config.min_scale;
+        controller.max_scale = m_config.max_scale;
+        m_controller.set_config(controller);
+    }
+
+    void reset() {
+        m_controller.reset();
+    }
+
+    // Returns true if the scale changed, always false while disabled
+    bool add_sample(float frame_ms) {
+        if (!m_config.enabled) {
+            return false;
+        }
+
+        return m_controller.add_sample(frame_ms);
+    }
+
+    bool is_enabled() const { return m_config.enabled; }
+    float get_scale() const { return m_config.enabled ? m_controller.get_scale() : 1.0f; }
+    const Config& get_config() const { return m_config; }
+    const FrameTimeController& get_controller() const { return m_controller; }
+
+    // Each eye is rounded down to the granularity on its own so both halves of the
+    // side by side target stay aligned, never below one granule
+    static Size compute(uint32_t eye_width, uint32_t eye_height, float scale, uint32_t granularity) {
+        if (eye_width == 0 || eye_height == 0) {
+            return {};
+        }
+
+        granularity = (std::max)(granularity, 1u);
+
+        const auto quantize = [&](uint32_t full) {
+            if (scale >= 1.0f) {
+                return full;
+            }
+
+            const auto scaled = (uint32_t)std::floor((float)full * scale);
+            return (std::min)(full, (std::max)(granularity, scaled - scaled % granularity));
+        };
+
+        return Size{quantize(eye_width) * 2, quantize(eye_height)};
+    }
+
+    Size compute(uint32_t eye_width, uint32_t eye_height) const {
+        return compute(eye_width, eye_height, get_scale(), m_config.granularity);
+    }
+
+private:
+    Config m_config{};
+    FrameTimeController m_controller{};
+};
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// Closed loop controller for a render scale, fed with present to present intervals. DynamicResolution uses
+// it to scale GSystemResolution, the scene's render resolution; it knows nothing about what it's scaling.
+// Samples are collected into windows, each finished window compares its average against the
+// target frame time and steps the scale down when over budget or up when well under it.
+// Presents are paced by the headset so intervals never drop below the refresh period, which means
+// "every frame made it" is the only sign of headroom there is. Stepping up is therefore a probe:
+// it needs several on-budget windows in a row, and each step up that gets undone right away
+// doubles the number of windows the next one needs (until reset()), so the controller settles
+// instead of oscillating. A detected refresh period that changes, in either direction, is only taken over
+// once the new one has held for detect_windows windows in a row.
+// No clocks or API calls in here, so recorded traces can be replayed through it as is.
+class FrameTimeController {
+public:
+    static constexpr uint32_t MAX_WINDOW = 240;
+
+    struct Config {
+        float min_scale{0.5f};
+        float max_scale{1.0f};
+        float step{0.05f};
+        float target_ms{0.0f};          // 0 = detect from the samples
+        float over_budget{1.05f};       // average above target * this steps down
+        float under_budget{1.01f};      // average below target * this counts towards stepping up
+        uint32_t window{45};            // samples per decision, at most MAX_WINDOW
+        uint32_t cooldown_windows{2};   // windows ignored after any change
+        uint32_t windows_to_increase{3};
+        uint32_t max_windows_to_increase{96};
+        uint32_t detect_windows{4};     // windows a different refresh period has to hold for before it's used
+    };
+
+    struct Stats {
+        uint64_t samples{0};
+        uint64_t windows{0};
+        uint32_t decreases{0};
+        uint32_t increases{0};
+        uint32_t failed_increases{0};   // step ups that were stepped back down in the next decision
+        uint32_t refresh_changes{0};    // detected refresh period switched after the first detection
+        float last_average_ms{0.0f};
+    };
+
+    FrameTimeController() = default;
+    FrameTimeController(const Config& config) { set_config(config); }
+
+    void set_config(const Config& config) {
+        m_config = config;
+        m_config.window = std::clamp<uint32_t>(m_config.window, 1, MAX_WINDOW);
+        m_config.min_scale = std::clamp(m_config.min_scale, 0.05f, 1.0f);
+        m_config.max_scale = std::clamp(m_config.max_scale, m_config.min_scale, 1.0f);
+        reset();
+    }
+
+    void reset() {
+        m_scale = m_config.max_scale;
+        m_count = 0;
+        m_cooldown = 0;
+        m_quiet_windows = 0;
+        m_windows_to_increase = m_config.windows_to_increase;
+        m_just_increased = false;
+        m_detected_ms = 0.0f;
+        m_candidate_ms = 0.0f;
+        m_candidate_windows = 0;
+        m_stats = {};
+    }
+
+    // Returns true if the scale changed
+    bool add_sample(float frame_ms) {
+        // Hitches (loading, alt-tab) say nothing about what the scale costs
+        if (!(frame_ms > 0.0f) || frame_ms > 250.0f) {
+            return false;
+        }
+
+        ++m_stats.samples;
+        m_samples[m_count++] = frame_ms;
+
+        if (m_count < m_config.window) {
+            return false;
+        }
+
+        m_count = 0;
+        return on_window();
+    }
+
+    float get_scale() const { return m_scale; }
+    uint32_t get_windows_to_increase() const { return m_windows_to_increase; }
+    float get_target_ms() const { return m_config.target_ms > 0.0f ? m_config.target_ms : m_detected_ms; }
+    const Config& get_config() const { return m_config; }
+    const Stats& get_stats() const { return m_stats; }
+
+    // Headsets run at one of a handful of refresh rates, an interval close to one of their periods
+    // (or a multiple of it, when every frame is being reprojected) is that rate.
+    // Exact periods win over multiples, so a 120Hz headset stuck at 60fps reads as 60Hz;
+    // set target_ms when that matters.
+    static float snap_to_refresh_rate(float ms) {
+        constexpr std::array<float, 7> rates{60.0f, 72.0f, 80.0f, 90.0f, 100.0f, 120.0f, 144.0f};
+
+        for (uint32_t multiple = 1; multiple <= 3; ++multiple) {
+            for (const auto rate : rates) {
+                const auto period = 1000.0f / rate;
+
+                if (std::abs(ms - period * multiple) <= period * multiple * 0.04f) {
+                    return period;
+                }
+            }
+        }
+
+        return ms;
+    }
+
+private:
+    bool on_window() {
+        ++m_stats.windows;
+
+        const auto begin = m_samples.begin();
+        const auto end = m_samples.begin() + m_config.window;
+
+        float sum = 0.0f;
+
+        for (auto it = begin; it != end; ++it) {
+            sum += *it;
+        }
+
+        const auto average = sum / (float)m_config.window;
+        m_stats.last_average_ms = average;
+
+        // The fastest tenth of the frames are the ones that made vsync, which gives the refresh period
+        if (m_config.target_ms <= 0.0f) {
+            auto tenth = begin + m_config.window / 10;
+            std::nth_element(begin, tenth, end);
+            detect_period(snap_to_refresh_rate(*tenth));
+        }
+
+        const auto target = get_target_ms();
+
+        if (target <= 0.0f) {
+            return false;
+        }
+
+        if (m_cooldown > 0) {
+            --m_cooldown;
+            return false;
+        }
+
+        const auto just_increased = m_just_increased;
+        m_just_increased = false;
+
+        if (average > target * m_config.over_budget) {
+            m_quiet_windows = 0;
+
+            if (just_increased) {
+                ++m_stats.failed_increases;
+                m_windows_to_increase = (std::min)(m_windows_to_increase * 2, m_config.max_windows_to_increase);
+            }
+
+            return apply((std::max)(m_config.min_scale, m_scale - m_config.step), m_stats.decreases);
+        }
+
+        if (average < target * m_config.under_budget) {
+            if (++m_quiet_windows >= m_windows_to_increase) {
+                m_quiet_windows = 0;
+                m_just_increased = apply((std::min)(m_config.max_scale, m_scale + m_config.step), m_stats.increases);
+                return m_just_increased;
+            }
+
+            return false;
+        }
+
+        m_quiet_windows = 0;
+        return false;
+    }
+
+    // A single odd window (hitches, a burst of reprojection) shouldn't move the target either way
+    void detect_period(float period) {
+        const auto same = [](float a, float b) { return std::abs(a - b) <= b * 0.02f; };
+
+        if (m_detected_ms <= 0.0f) {
+            m_detected_ms = period;
+            return;
+        }
+
+        if (same(period, m_detected_ms)) {
+            m_candidate_windows = 0;
+            return;
+        }
+
+        if (m_candidate_windows == 0 || !same(period, m_candidate_ms)) {
+            m_candidate_ms = period;
+            m_candidate_windows = 0;
+        }
+
+        if (++m_candidate_windows >= m_config.detect_windows) {
+            m_detected_ms = m_candidate_ms;
+            m_candidate_windows = 0;
+            ++m_stats.refresh_changes;
+        }
+    }
+
+    bool apply(float scale, uint32_t& counter) {
+        if (scale == m_scale) {
+            return false;
+        }
+
+        m_scale = scale;
+        m_cooldown = m_config.cooldown_windows;
+        ++counter;
+        return true;
+    }
+
+    Config m_config{};
+    Stats m_stats{};
+    std::array<float, MAX_WINDOW> m_samples{};
+    uint32_t m_count{0};
+    uint32_t m_cooldown{0};
+    uint32_t m_quiet_windows{0};
+    uint32_t m_windows_to_increase{3};
+    bool m_just_increased{false};
+    float m_scale{1.0f};
+    float m_detected_ms{0.0f};
+    float m_candidate_ms{0.0f};
+    uint32_t m_candidate_windows{0};
+};
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+// Every piece of GPU work the plugin inserts into the frame
+enum class GpuOp : uint8_t {
+    ClearUI,
+    SnapshotUI,
+    ProbeUI,
+    Count
+};
+
+inline const char* get_gpu_op_name(GpuOp op) {
+    switch (op) {
+    case GpuOp::ClearUI:
+        return "ClearUI";
+    case GpuOp::SnapshotUI:
+        return "SnapshotUI";
+    case GpuOp::ProbeUI:
+        return "ProbeUI";
+    default:
+        return "Unknown";
+    }
+}
+
+struct GpuOpTiming {
+    float gpu_us{0.0f};
+    float cpu_us{0.0f};
+    uint64_t frame{0}; // profiler frame the timing was recorded in, not the one it got resolved in
+};
+
+using GpuOpTimings = std::array<GpuOpTiming, (size_t)GpuOp::Count>;
+
+// Shared with the query backends so they can size their heaps
+constexpr uint32_t GPU_PROFILER_FRAMES = 4;
+constexpr uint32_t GPU_PROFILER_MAX_SCOPES = 8;
+constexpr uint32_t GPU_PROFILER_MAX_TIMESTAMPS = GPU_PROFILER_MAX_SCOPES * 2;
+
+// Frame ring of timestamp scopes, resolved a few frames later without ever waiting on the GPU.
+// Queries is the API specific part and needs to provide:
+//   using Context = ...;                                   // whatever the timestamps get written into
+//   bool begin_frame(uint32_t slot);                        // false if the slot can't be used this frame
+//   void timestamp(uint32_t slot, uint32_t index, Context); // index < GPU_PROFILER_MAX_TIMESTAMPS
+//   bool end_frame(uint32_t slot, uint32_t count);          // true if the slot will become readable
+//   bool read(uint32_t slot, uint32_t count, uint64_t* out, uint64_t& frequency); // non-blocking, false if not ready
+// which keeps the ring logic itself independent of D3D11/D3D12.
+template <typename Queries>
+class GpuProfiler {
+public:
+    static constexpr uint32_t NUM_FRAMES = GPU_PROFILER_FRAMES;
+    static constexpr uint32_t MAX_SCOPES = GPU_PROFILER_MAX_SCOPES;
+    static constexpr uint32_t MAX_TIMESTAMPS = GPU_PROFILER_MAX_TIMESTAMPS;
+    static constexpr uint32_t INVALID_SCOPE = ~0u;
+
+    using Context = typename Queries::Context;
+
+    class Scope {
+    public:
+        Scope(GpuProfiler& profiler, GpuOp op, Context ctx)
+            : m_profiler{profiler},
+            m_ctx{ctx},
+            m_index{profiler.begin_scope(op, ctx)}
+        {
+        }
+
+        ~Scope() {
+            m_profiler.end_scope(m_index, m_ctx);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        GpuProfiler& m_profiler;
+        Context m_ctx;
+        uint32_t m_index;
+    };
+
+    Queries& get_queries() { return m_queries; }
+
+    void begin_frame() {
+        collect();
+
+        const auto frame = ++m_frame_count;
+        m_current = (uint32_t)(frame % NUM_FRAMES);
+        auto& f = m_frames[m_current];
+
+        // Still waiting on the GPU from NUM_FRAMES ago, skip profiling this frame instead of stalling
+        if (f.pending) {
+            m_active = false;
+            ++m_skipped_frames;
+            return;
+        }
+
+        m_active = m_queries.begin_frame(m_current);
+        f.frame = frame;
+        f.num_scopes = 0;
+    }
+
+    void end_frame() {
+        if (!m_active) {
+            return;
+        }
+
+        auto& f = m_frames[m_current];
+        const auto submitted = m_queries.end_frame(m_current, f.num_scopes * 2);
+
+        // A slot whose resolve never got submitted would read back whatever the last frame left there
+        f.pending = submitted && f.num_scopes > 0;
+        m_active = false;
+    }
+
+    uint32_t begin_scope(GpuOp op, Context ctx) {
+        if (!m_active) {
+            return INVALID_SCOPE;
+        }
+
+        auto& f = m_frames[m_current];
+
+        if (f.num_scopes >= MAX_SCOPES) {
+            return INVALID_SCOPE;
+        }
+
+        const auto index = f.num_scopes++;
+        auto& scope = f.scopes[index];
+        scope.op = op;
+        scope.cpu_start = std::chrono::high_resolution_clock::now();
+
+        m_queries.timestamp(m_current, index * 2, ctx);
+
+        return index;
+    }
+
+    void end_scope(uint32_t index, Context ctx) {
+        if (index == INVALID_SCOPE || !m_active) {
+            return;
+        }
+
+        auto& scope = m_frames[m_current].scopes[index];
+        m_queries.timestamp(m_current, index * 2 + 1, ctx);
+        scope.cpu_us = std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - scope.cpu_start).count();
+    }
+
+    // Resolves every slot the GPU has finished with, oldest first
+    void collect() {
+        for (uint32_t i = 1; i <= NUM_FRAMES; ++i) {
+            const auto slot = (m_current + i) % NUM_FRAMES;
+            auto& f = m_frames[slot];
+
+            if (!f.pending) {
+                continue;
+            }
+
+            std::array<uint64_t, MAX_TIMESTAMPS> timestamps{};
+            uint64_t frequency{0};
+
+            if (!m_queries.read(slot, f.num_scopes * 2, timestamps.data(), frequency)) {
+                continue;
+            }
+
+            f.pending = false;
+
+            // Frequency of 0 means the timestamps are unreliable (e.g. D3D11 disjoint), but the slot is still free again
+            if (frequency == 0) {
+                continue;
+            }
+
+            for (uint32_t s = 0; s < f.num_scopes; ++s) {
+                const auto& scope = f.scopes[s];
+                const auto begin = timestamps[s * 2];
+                const auto end = timestamps[s * 2 + 1];
+                auto& timing = m_timings[(size_t)scope.op];
+
+                timing.gpu_us = end > begin ? (float)((double)(end - begin) * 1'000'000.0 / (double)frequency) : 0.0f;
+                timing.cpu_us = scope.cpu_us;
+                timing.frame = f.frame;
+            }
+
+            ++m_resolved_frames;
+        }
+    }
+
+    void reset() {
+        for (uint32_t i = 0; i < NUM_FRAMES; ++i) {
+            m_frames[i].pending = false;
+            m_frames[i].num_scopes = 0;
+        }
+
+        m_active = false;
+    }
+
+    const GpuOpTimings& get_timings() const { return m_timings; }
+    uint32_t num_skipped_frames() const { return m_skipped_frames; }
+    uint32_t num_resolved_frames() const { return m_resolved_frames; }
+
+private:
+    struct ScopeData {
+        GpuOp op{GpuOp::Count};
+        std::chrono::high_resolution_clock::time_point cpu_start{};
+        float cpu_us{0.0f};
+    };
+
+    struct Frame {
+        std::array<ScopeData, MAX_SCOPES> scopes{};
+        uint32_t num_scopes{0};
+        uint64_t frame{0};
+        bool pending{false};
+    };
+
+    Queries m_queries{};
+    std::array<Frame, NUM_FRAMES> m_frames{};
+    GpuOpTimings m_timings{};
+    uint64_t m_frame_count{0};
+    uint32_t m_current{0};
+    uint32_t m_skipped_frames{0};
+    uint32_t m_resolved_frames{0};
+    bool m_active{false};
+};
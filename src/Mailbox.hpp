@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <cstdint>
+
+// Lock-free single producer, single consumer handoff where only the latest item matters.
+// push() must only ever be called from one thread and pop() from one other thread.
+// A push the consumer hasn't picked up yet is replaced by the next one instead of being queued,
+// so the producer never has to drop the newest item because the consumer stalled.
+// Three slots: the producer writes the back one, the consumer reads the front one and the
+// middle one is swapped between them atomically. Nothing here ever blocks or allocates.
+template <typename T>
+class Mailbox {
+public:
+    void push(const T& item) {
+        m_slots[m_back].item = item;
+
+        const auto prev = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel);
+        m_back = prev & INDEX;
+
+        if ((prev & FRESH) != 0) {
+            m_replaced.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::optional<T> pop() {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return std::nullopt;
+        }
+
+        // Only the producer can touch the middle slot now and it only ever puts a fresh one back
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+        return m_slots[m_front].item;
+    }
+
+    bool empty() const {
+        return (m_middle.load(std::memory_order_acquire) & FRESH) == 0;
+    }
+
+    // Pushes that replaced one the consumer never saw
+    uint32_t num_replaced() const {
+        return m_replaced.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint8_t INDEX = 0b011;
+    static constexpr uint8_t FRESH = 0b100;
+
+    struct alignas(64) Slot {
+        T item{};
+    };
+
+    // Producer and consumer state live on separate cache lines so they don't ping-pong
+    Slot m_slots[3]{};
+    alignas(64) uint8_t m_back{0};  // producer only
+    alignas(64) uint8_t m_front{2}; // consumer only
+    alignas(64) std::atomic<uint8_t> m_middle{1};
+    std::atomic<uint32_t> m_replaced{0};
+};
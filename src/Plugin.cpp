@@ -1,5 +1,8 @@
+#include <algorithm>
+#include <atomic>
 #include <optional>
-#include <mutex>
+#include <utility>
+#include <chrono>
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_sinks.h>
 
@@ -12,50 +15,22 @@
 #include <utility/Module.hpp>
 #include <utility/Patch.hpp>
 
-#include <GraphicsMemory.h>
-
-#include "d3d12/ComPtr.hpp"
-#include "d3d12/CommandContext.hpp"
-#include "d3d12/TextureContext.hpp"
-
 #include "uevr/Plugin.hpp"
 
-using namespace uevr;
-
-HRESULT clear_d3d11_rt(ID3D11Device* device, ID3D11Texture2D* texture, const float* clear_color, std::optional<DXGI_FORMAT> format = std::nullopt) {
-    // Create a temporary render target view
-    // This is meant to be called infrequently so it's fine to create and destroy the view every time
-    d3d12::ComPtr<ID3D11RenderTargetView> rtv{};
-
-    if (format) {
-        D3D11_RENDER_TARGET_VIEW_DESC rtv_desc{};
-        rtv_desc.Format = *format;
-        rtv_desc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
-        rtv_desc.Texture2D.MipSlice = 0;
-        if (auto result = device->CreateRenderTargetView(texture, &rtv_desc, &rtv); FAILED(result)) {
-            return result;
-        }
-    } else {
-        if (auto result = device->CreateRenderTargetView(texture, nullptr, &rtv); FAILED(result)) {
-            format = DXGI_FORMAT_B8G8R8A8_UNORM;
-
-            D3D11_RENDER_TARGET_VIEW_DESC rtv_desc{};
-            rtv_desc.Format = *format;
-            rtv_desc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
-            rtv_desc.Texture2D.MipSlice = 0;
-            if (auto result = device->CreateRenderTargetView(texture, &rtv_desc, &rtv); FAILED(result)) {
-                return result;
-            }
-        }
-    }
+#include "CVarPreset.hpp"
+#include "CVarRegistry.hpp"
+#include "ConsoleIndex.hpp"
+#include "DynamicResolution.hpp"
+#include "Mailbox.hpp"
+#include "PluginConfig.hpp"
+#include "PresetTuner.hpp"
+#include "Renderer.hpp"
+#include "ResolutionPublisher.hpp"
+#include "UIDensity.hpp"
+#include "UIPresentWork.hpp"
+#include "UIRenderTargetSwap.hpp"
 
-    // Clear the render target
-    d3d12::ComPtr<ID3D11DeviceContext> context{nullptr};
-    device->GetImmediateContext(&context);
-    context->ClearRenderTargetView(rtv.Get(), clear_color);
-
-    return S_OK;
-}
+using namespace uevr;
 
 class SimpleScheduler {
 public:
@@ -99,7 +74,6 @@ public:
     };
 
     virtual ~FF7Plugin() {
-        std::scoped_lock _{m_present_mutex};
         m_light_flagspatch.reset();
     }
 
@@ -167,72 +141,329 @@ public:
 
         SPDLOG_INFO("FF7Plugin entry point");
 
+        load_config();
         resolve_system_resolution();
         render_lights_patch();
+        load_vr_presets();
+    }
+
+    // ff7plugin.txt in the persistent dir, everything in it is optional
+    void load_config() {
+        const auto path = API::get()->get_persistent_dir(L"ff7plugin.txt");
+        const auto config = PluginConfig::load(path);
+
+        UIPresentWork::Config ui_work{};
+        ui_work.snapshots = config.get_bool("UI_Snapshots", false);
+        ui_work.probe = config.get_bool("UI_Probe", false);
+        m_ui_work.set_config(ui_work);
+
+        m_stats_log_frames = config.get_number<uint32_t>("Stats_Log_Frames", m_stats_log_frames);
+        m_upload_trim_frames = config.get_number<uint32_t>("Upload_Trim_Idle_Frames", m_upload_trim_frames);
+
+        DynamicResolution::Config dynamic_resolution{};
+        dynamic_resolution.enabled = config.get_bool("Dynamic_Resolution", false);
+        dynamic_resolution.min_scale = config.get_number("Dynamic_Resolution_Min_Scale", dynamic_resolution.min_scale);
+        dynamic_resolution.max_scale = config.get_number("Dynamic_Resolution_Max_Scale", dynamic_resolution.max_scale);
+        dynamic_resolution.granularity = config.get_number("Dynamic_Resolution_Granularity", dynamic_resolution.granularity);
+        dynamic_resolution.controller.target_ms = config.get_number("Dynamic_Resolution_Target_Ms", 0.0f); // 0 detects the refresh rate
+        set_dynamic_resolution(dynamic_resolution);
+
+        if (m_dynamic_resolution.is_enabled()) {
+            const auto& applied = m_dynamic_resolution.get_config();
+            API::get()->log_info("Dynamic resolution between %.2f and %.2f of the HMD resolution, %u pixel steps",
+                applied.min_scale, applied.max_scale, applied.granularity);
+        }
+
+        if (const auto preset = config.get("VR_Preset"); preset && !preset->empty()) {
+            m_vr_preset_name = std::wstring{preset->begin(), preset->end()};
+        }
+
+        API::get()->log_info("Loaded %u settings from %ls (UI snapshots %s, UI probe %s, stats every %u frames, VR preset %ls)",
+            (uint32_t)config.size(), path.c_str(), ui_work.snapshots ? "on" : "off", ui_work.probe ? "on" : "off", m_stats_log_frames,
+            m_vr_preset_name.c_str());
+
+        // Runs once, delete presets/tuned.txt to tune again
+        if (config.get_bool("Preset_Tuning", false)) {
+            const auto tuned = API::get()->get_persistent_dir(L"presets") / L"tuned.txt";
+
+            if (std::filesystem::exists(tuned)) {
+                API::get()->log_info("Preset tuning skipped, %ls already exists", tuned.c_str());
+            } else {
+                PresetTuner::Config tuning{};
+                tuning.target_ms = config.get_number("Preset_Tuning_Target_Ms", tuning.target_ms);
+                start_preset_tuning(tuning);
+            }
+        }
+    }
+
+    void load_vr_presets() {
+        m_vr_presets = CVarPreset::load_all(API::get()->get_persistent_dir(L"presets"));
+
+        for (const auto& preset : m_vr_presets) {
+            API::get()->log_info("Loaded cvar preset %ls (%u cvars)", preset.name.c_str(), (uint32_t)preset.values.size());
+        }
+    }
+
+    // The preset applied while the HMD is active, presets/vr.txt by default.
+    // A preset that's applied right now gets swapped on the next engine tick, with the tuner's values
+    // taken off first and put back on top of the new one. Game thread only.
+    void select_vr_preset(std::wstring name) {
+        m_vr_preset_name = std::move(name);
+
+        if (m_tuner_applier.is_applied()) {
+            m_tuner_applier.restore();
+            m_tuner_pending_apply = true;
+        }
+
+        m_vr_preset.restore();
+    }
+
+    const CVarPresetApplier::Stats& get_vr_preset_stats() const {
+        return m_vr_preset.get_stats();
+    }
+
+    // Searches the cvar values listed in tuning.txt (in the persistent dir) for the best looking configuration
+    // that holds config.target_ms, and saves it as presets/tuned.txt. Only runs while the HMD is active,
+    // on top of the VR preset. Started from ff7plugin.txt with Preset_Tuning=true. Game thread only.
+    bool start_preset_tuning(const PresetTuner::Config& config) {
+        auto space = PresetTuner::load_space(API::get()->get_persistent_dir(L"tuning.txt"));
+
+        if (space.empty()) {
+            API::get()->log_error("Nothing to tune, tuning.txt is missing or empty");
+            return false;
+        }
+
+        API::get()->log_info("Tuning %u cvars for %.2fms", (uint32_t)space.size(), config.target_ms);
+
+        m_tuner.start(std::move(space), config);
+        m_tuner_pending_apply = true;
+        return true;
     }
 
+    const PresetTuner::Stats& get_preset_tuning_stats() const {
+        return m_tuner.get_stats();
+    }
+
+    // No lock here, anything coming from the render thread arrives through m_gpu_work.
+    // on_device_reset is called from the same thread as on_present.
     void on_present() {
-        std::scoped_lock _{m_present_mutex};
+        (this->*m_present_fn)();
+    }
 
-        const auto is_d3d11 = API::get()->param()->renderer->renderer_type == UEVR_RENDERER_D3D11;
+    // GPU and CPU time of each plugin operation, resolved a few frames after it was recorded
+    GpuOpTimings get_gpu_timings() const {
+        if (m_renderer == nullptr) {
+            return {};
+        }
 
-        if (!is_d3d11) {
-            init_d3d12();
+        return m_renderer->get_gpu_timings();
+    }
+
+    // Latest completed copy of the UI render target, a few frames old.
+    // Never blocks, returns nullopt until the first copy has landed or without UI_Snapshots=true.
+    // Present thread only.
+    std::optional<ReadbackView> get_ui_snapshot() {
+        if (m_renderer == nullptr) {
+            return std::nullopt;
         }
 
-        ++m_frame_index;
+        return m_renderer->map_ui_snapshot();
+    }
 
-        if (m_ui_tex_to_clear != nullptr) {
-            auto native_resource = m_ui_tex_to_clear->get_native_resource();
+    // Whether anything was drawn into the UI a few frames ago, nullopt until the first probe lands
+    std::optional<bool> is_ui_empty() const {
+        const auto& stats = m_ui_work.get_empty_stats();
 
-            if (native_resource != nullptr) {
-                if (is_d3d11) {
-                    auto device = (ID3D11Device*)API::get()->param()->renderer->device;
-                    float clear_color[4]{0.0f, 0.0f, 0.0f, 1.0f}; // why is the alpha channel 1.0f? it works though
-                    if (FAILED(clear_d3d11_rt(device, (ID3D11Texture2D*)native_resource, clear_color))) {
-                        API::get()->log_error("Failed to clear D3D11 render target");
-                    }
-                } else {
-                    auto& command_context = m_d3d12_commands[m_frame_index % 3];
-                    
-                    command_context.wait(2000);
-
-                    m_d3d12_ui_tex.setup((ID3D12Device*)API::get()->param()->renderer->device, (ID3D12Resource*)native_resource, DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_FORMAT_B8G8R8A8_UNORM);
-                    const float clear_color[4]{0.0f, 0.0f, 0.0f, 1.0f};
-                    command_context.clear_rtv(m_d3d12_ui_tex, clear_color, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-                    command_context.execute((ID3D12CommandQueue*)API::get()->param()->renderer->command_queue);
-                }
+        if (!stats.latest) {
+            return std::nullopt;
+        }
+
+        return stats.latest->empty;
+    }
 
-                m_ui_tex_to_clear = nullptr;
+    const UIEmptyStats& get_ui_empty_stats() const {
+        return m_ui_work.get_empty_stats();
+    }
+
+    // Logs the UI resolution matching the headset's pixel density at the configured UI_Size/UI_Distance,
+    // once, the first time the HMD is active. Only reported: the engine draws the UI at
+    // r.InGameUI.FixedWidth/FixedHeight into UEVR's UI render target, so anything smaller than that
+    // target would end up in its top left corner. Game thread only.
+    void log_ui_density() {
+        if (m_ui_density_logged) {
+            return;
+        }
+
+        const auto vr = API::get()->param()->vr;
+        const auto ui_w = (uint32_t)vr->get_ui_width();
+        const auto ui_h = (uint32_t)vr->get_ui_height();
+
+        if (!vr->is_hmd_active() || ui_w == 0 || ui_h == 0) {
+            return;
+        }
+
+        m_ui_density_logged = true;
+
+        UEVR_Matrix4x4f projection{};
+        vr->get_ue_projection_matrix(UEVR_LEFT_EYE, &projection);
+
+        UIDensity::Input input{};
+        input.placement = UIPlacement::load(API::get()->get_persistent_dir(L"config.txt")).value_or(UIPlacement{});
+        input.projection_x_scale = projection.m[0][0];
+        input.projection_y_scale = projection.m[1][1];
+        input.eye_width = vr->get_hmd_width();
+        input.eye_height = vr->get_hmd_height();
+        input.ui_width = ui_w;
+        input.ui_height = ui_h;
+
+        const auto result = UIDensity::compute(input);
+
+        if (!result) {
+            return;
+        }
+
+        API::get()->log_info("UI density: %.1fx%.1f px/deg, UI covers %.1fx%.1f deg, %ux%u would be enough (%ux%u target)",
+            result->pixels_per_degree_x, result->pixels_per_degree_y, result->ui_degrees_x, result->ui_degrees_y,
+            result->width, result->height, ui_w, ui_h);
+    }
+
+    // Scales GSystemResolution within the configured bounds when enabled, off by default.
+    // Set from the Dynamic_Resolution* keys in ff7plugin.txt at initialize, call before the first present.
+    void set_dynamic_resolution(const DynamicResolution::Config& config) {
+        m_dynamic_resolution.set_config(config);
+        m_system_resolution_scale.store(m_dynamic_resolution.get_scale(), std::memory_order_relaxed);
+    }
+
+    const FrameTimeController::Stats& get_dynamic_resolution_stats() const {
+        return m_dynamic_resolution.get_controller().get_stats();
+    }
+
+    // How often GSystemResolution was actually written, game thread only
+    const ResolutionPublisher::Stats& get_system_resolution_stats() const {
+        return m_system_resolution_publisher.get_stats();
+    }
+
+    // Game thread only
+    bool initialize_cvars() {
+        return m_cvar_registry.resolve();
+    }
+
+    const CVarBatch::Stats& get_cvar_batch_stats() const {
+        return m_cvar_registry.get_batch().get_stats();
+    }
+
+    const CVarRegistry::Stats& get_cvar_registry_stats() const {
+        return m_cvar_registry.get_stats();
+    }
+
+    // Every console object by name and prefix, caught up with newly registered objects on each call.
+    // Empty until the console manager exists. Game thread only.
+    const ConsoleIndex& get_console_index() {
+        const auto& stats = m_console_index.get_stats();
+        const auto bad_layouts = stats.bad_layouts;
+
+        if (m_console_index.update(API::get()->get_console_manager())) {
+            SPDLOG_DEBUG("Console index has {} entries ({} full, {} incremental builds)",
+                stats.entries, stats.full_builds, stats.incremental_builds);
+        } else if (bad_layouts == 0 && stats.bad_layouts > 0) {
+            API::get()->log_warn("Console object map doesn't look like a TSparseArray, cvars are looked up through the engine instead");
+        }
+
+        return m_console_index;
+    }
+
+    // Everything queued during the last frame's viewport draw gets written here, before the engine ticks
+    void on_pre_engine_tick(API::UGameEngine* engine, float delta) override {
+        if (m_cvar_registry.is_resolved()) {
+            m_cvar_registry.get_batch().flush();
+
+            // The tuner's values sit on top of the VR preset: the preset goes on first and comes off last,
+            // so a cvar that's in both ends up back at its value from before either of them
+            const auto is_hmd_active = API::get()->param()->vr->is_hmd_active();
+
+            if (is_hmd_active) {
+                update_vr_preset(is_hmd_active);
+                update_preset_tuning(is_hmd_active, delta);
+            } else {
+                update_preset_tuning(is_hmd_active, delta);
+                update_vr_preset(is_hmd_active);
+            }
+        }
+
+        log_ui_density();
+    }
+
+    void update_preset_tuning(bool is_hmd_active, float delta) {
+        if (!is_hmd_active) {
+            // Paused, the trial starts over with its values applied again once the HMD is back
+            if (m_tuner_applier.is_applied()) {
+                m_tuner_applier.restore();
+                m_tuner.restart_trial();
+                m_tuner_pending_apply = m_tuner.is_running();
+                API::get()->log_info("Preset tuning paused, the HMD is no longer active");
             }
+
+            return;
         }
 
-        if (!is_d3d11) {
-            if (m_graphics_memory != nullptr) {
-                auto command_queue = (ID3D12CommandQueue*)API::get()->param()->renderer->command_queue;
+        const auto pending = std::exchange(m_tuner_pending_apply, false);
+        auto changed = false;
+
+        if (m_tuner.is_running()) {
+            const PresetTuner::Sample sample{m_last_present_ms.load(std::memory_order_relaxed), delta * 1000.0f};
+            const auto measured = m_tuner.get_stats().measured;
+            changed = m_tuner.add_sample(sample);
 
-                m_graphics_memory->Commit(command_queue);
+            if (const auto& stats = m_tuner.get_stats(); stats.measured != measured) {
+                API::get()->log_info("Preset tuning trial %u: %.2fms present, %.2fms tick (%u accepted, %u rejected so far)",
+                    stats.measured, stats.last_present_ms, stats.last_tick_ms, stats.accepted, stats.rejected);
             }
         }
+
+        if (changed || pending) {
+            m_tuner_applier.apply(m_tuner.get_preset(L"tuned"), get_console_index());
+        }
+
+        if (m_tuner.get_state() == PresetTuner::State::Done) {
+            const auto preset = m_tuner.get_preset(L"tuned");
+            const auto path = API::get()->get_persistent_dir(L"presets") / L"tuned.txt";
+            const auto& stats = m_tuner.get_stats();
+
+            if (preset.save(path)) {
+                API::get()->log_info("Preset tuning done after %u trials (%u accepted), saved to %ls", stats.trials, stats.accepted, path.c_str());
+            } else {
+                API::get()->log_error("Preset tuning done, but %ls couldn't be written", path.c_str());
+            }
+
+            m_tuner.stop();
+        }
     }
 
-    bool initialize_cvars() {
-        if (m_cvars.initialized) {
-            return true;
+    // Same rollback as the UI cvars get, everything the preset changed goes back when the HMD is gone
+    void update_vr_preset(bool is_hmd_active) {
+        if (is_hmd_active == m_vr_preset.is_applied() || m_vr_presets.empty()) {
+            return;
         }
 
-        const auto console = API::get()->get_console_manager();
+        if (!is_hmd_active) {
+            m_vr_preset.restore();
 
-        if (console == nullptr) {
-            return false;
+            const auto& stats = m_vr_preset.get_stats();
+            API::get()->log_info("Restored %u cvars (%u changed since, left alone)", stats.restored, stats.kept);
+            return;
+        }
+
+        const auto preset = std::find_if(m_vr_presets.begin(), m_vr_presets.end(), [&](const auto& p) { return p.name == m_vr_preset_name; });
+
+        if (preset == m_vr_presets.end()) {
+            return;
         }
 
-        m_cvars.r_InGameUI_FixedHeight = console->find_variable(L"r.InGameUI.FixedHeight");
-        m_cvars.r_InGameUI_FixedWidth = console->find_variable(L"r.InGameUI.FixedWidth");
-        m_cvars.initialized = m_cvars.r_InGameUI_FixedHeight != nullptr && 
-                              m_cvars.r_InGameUI_FixedWidth != nullptr;
+        m_vr_preset.apply(*preset, get_console_index());
 
-        return m_cvars.initialized;
+        const auto& stats = m_vr_preset.get_stats();
+        API::get()->log_info("Applied cvar preset %ls: %u written, %u unchanged, %u missing, %u not matching, %u can't be restored",
+            preset->name.c_str(), stats.written, stats.unchanged, stats.missing, stats.mismatched, stats.unrestorable);
     }
 
     void on_pre_viewport_client_draw(UEVR_UGameViewportClientHandle viewport_client, UEVR_FViewportHandle viewport, UEVR_FCanvasHandle) {
@@ -251,25 +482,53 @@ public:
                 return;
             }
 
-            // TODO: Figure out why this crashes DX12
-            if (m_cvars.r_InGameUI_FixedWidth->get_int() != w - 1) {
-                m_cvars.r_InGameUI_FixedWidth->set(w - 1);
+            // Setting these from here directly crashed DX12 (TODO: figure out why), so they're only queued
+            // here and the batch writes them from on_pre_engine_tick.
+            // Enforced, so the batch also puts them back if the console or the game changes them.
+            m_cvars.r_InGameUI_FixedWidth.set_enforced(true);
+            m_cvars.r_InGameUI_FixedHeight.set_enforced(true);
+
+            if (m_cvars.r_InGameUI_FixedWidth.set(w - 1)) {
                 m_cvars.dirty = true;
             }
 
-            if (m_cvars.r_InGameUI_FixedHeight->get_int() != h - 1) {
-                m_cvars.r_InGameUI_FixedHeight->set(h - 1);
+            if (m_cvars.r_InGameUI_FixedHeight.set(h - 1)) {
                 m_cvars.dirty = true;
             }
 
             if (m_system_resolution != nullptr) {
-                m_system_resolution[0] = vr->get_hmd_width() * 2;
-                m_system_resolution[1] = vr->get_hmd_height();
+                const auto size = DynamicResolution::compute(vr->get_hmd_width(), vr->get_hmd_height(),
+                    m_system_resolution_scale.load(std::memory_order_relaxed), m_dynamic_resolution.get_config().granularity);
+
+                const ResolutionPublisher::Size in_memory{(uint32_t)m_system_resolution[0], (uint32_t)m_system_resolution[1]};
+
+                if (const auto publish = m_system_resolution_publisher.update(size, in_memory); publish) {
+                    const auto& stats = m_system_resolution_publisher.get_stats();
+                    const auto reasserts = m_system_resolution_publisher.get_reasserts_since_publish();
+
+                    // The engine may rewrite it every frame, only the first rewrite after a publish gets logged
+                    if (reasserts == 0) {
+                        API::get()->log_info("GSystemResolution %ux%u -> %ux%u (%u resizes, %u coalesced, %u rewrites)",
+                            in_memory.width, in_memory.height, publish->width, publish->height,
+                            stats.publishes, stats.coalesced, stats.reasserts);
+                    } else if (reasserts == 1) {
+                        API::get()->log_info("GSystemResolution was changed to %ux%u, writing %ux%u back (further rewrites are only counted)",
+                            in_memory.width, in_memory.height, publish->width, publish->height);
+                    }
+
+                    m_system_resolution[0] = (int32_t)publish->width;
+                    m_system_resolution[1] = (int32_t)publish->height;
+                }
             }
         } else {
+            m_system_resolution_publisher.reset();
+
+            m_cvars.r_InGameUI_FixedWidth.set_enforced(false);
+            m_cvars.r_InGameUI_FixedHeight.set_enforced(false);
+
             if (m_cvars.dirty) {
-                m_cvars.r_InGameUI_FixedWidth->set(0);
-                m_cvars.r_InGameUI_FixedHeight->set(0);
+                m_cvars.r_InGameUI_FixedWidth.set(0);
+                m_cvars.r_InGameUI_FixedHeight.set(0);
                 m_cvars.dirty = false;
             }
         }
@@ -277,123 +536,300 @@ public:
 
     // Only used because this function gets called on the render thread
     void on_pre_slate_draw_window(UEVR_FSlateRHIRendererHandle renderer, UEVR_FViewportInfoHandle viewport_info) override {
-        if (!initialize_cvars()) {
+        // The cvars are resolved by the game thread, nothing to do here until then
+        if (!m_cvar_registry.is_resolved()) {
             return;
         }
 
-        API::RenderTargetPoolHook::activate();
+        auto rt = m_ui_rt.get();
 
-        auto rt = API::RenderTargetPoolHook::get_render_target(L"InGameUIRenderTarget");
+        if (m_ui_rt.get_generation() != m_ui_rt_generation) {
+            m_ui_rt_generation = m_ui_rt.get_generation();
+            API::get()->log_info("InGameUIRenderTarget is now %p (generation %u)", (void*)rt, m_ui_rt_generation);
+        }
 
         if (rt != nullptr) {
             replace_ingame_ui_render_target(rt);
         } else {
-            m_last_engine_ui_tex = nullptr;
-            m_last_engine_ui_srt = nullptr;
+            m_ui_swap.on_target_missing();
+            m_ui_draw_target.store(nullptr, std::memory_order_relaxed);
         }
     }
 
     void replace_ingame_ui_render_target(API::IPooledRenderTarget* rtb) {
         auto rt = (IPooledRenderTargetImpl*)rtb;
         const auto is_hmd_active = API::get()->param()->vr->is_hmd_active();
+        const auto ui_render_target = API::StereoHook::get_ui_render_target();
 
-        if (m_last_engine_ui_tex != nullptr && !is_hmd_active) {
-            // Restore the original render target if the HMD is not active
-            if (rt->data.texture != nullptr && (rt->data.texture == API::StereoHook::get_ui_render_target() || rt->data.texture == m_last_ui_tex)) {
-                rt->data.texture = m_last_engine_ui_tex;
-                //rt->data.srt_texture = m_last_engine_ui_srt;
-            }
+        const auto result = m_ui_swap.update(rt->data.texture, rt->data.srt_texture, ui_render_target, is_hmd_active);
+        rt->data.texture = result.texture;
+        m_ui_draw_target.store(result.texture, std::memory_order_relaxed);
+        //rt->data.srt_texture = ...; // leaving the SRT alone works fine
 
-            m_last_engine_ui_tex = nullptr;
-            m_last_engine_ui_srt = nullptr;
-            m_last_ui_tex = nullptr;
+        if (result.clear != nullptr) {
+            m_gpu_work.push(GpuWorkItem{GpuWorkItem::Type::ClearUI, result.clear, std::chrono::steady_clock::now()});
         }
+    }
 
-        if (rt->data.texture == nullptr || !is_hmd_active) {
-            m_last_engine_ui_tex = nullptr;
-            m_last_ui_tex = nullptr;
-            return;
+private:
+    Patch::Ptr m_light_flagspatch{};
+
+    UIRenderTargetSwap<API::FRHITexture2D> m_ui_swap{}; // Render thread only
+    API::RenderTargetPoolHook::Handle m_ui_rt{API::RenderTargetPoolHook::register_render_target(L"InGameUIRenderTarget")}; // Render thread only
+    uint32_t m_ui_rt_generation{0};
+
+    // Render thread -> present thread, only the latest swap matters so an unconsumed one is replaced
+    struct GpuWorkItem {
+        enum class Type : uint8_t {
+            ClearUI,
+        };
+
+        Type type{Type::ClearUI};
+        API::FRHITexture2D* texture{nullptr};
+        std::chrono::steady_clock::time_point published{};
+    };
+
+    Mailbox<GpuWorkItem> m_gpu_work{};
+
+    struct {
+        std::chrono::microseconds last{};
+        std::chrono::microseconds max{};
+        std::chrono::microseconds total{};
+        uint32_t count{0};
+    } m_handoff_stats{};
+
+    API::FRHITexture2D* m_ui_tex_to_clear{nullptr}; // Present thread only
+
+    // Whatever the engine draws the UI into right now: UEVR's UI render target while swapped, its own texture otherwise
+    std::atomic<API::FRHITexture2D*> m_ui_draw_target{nullptr};
+
+    DynamicResolution m_dynamic_resolution{}; // Present thread only, config is fixed after the first present
+    std::atomic<float> m_system_resolution_scale{1.0f}; // Present thread -> game thread
+    std::chrono::steady_clock::time_point m_last_present{};
+    std::atomic<float> m_last_present_ms{0.0f}; // Present thread -> game thread
+
+    struct {
+        bool dirty{false};
+        CVarShadow<int> r_InGameUI_FixedWidth{};
+        CVarShadow<int> r_InGameUI_FixedHeight{};
+    } m_cvars{}; // Game thread only
+
+    ConsoleIndex m_console_index{}; // Game thread only
+    bool m_ui_density_logged{false}; // Game thread only
+
+    std::vector<CVarPreset> m_vr_presets{};
+    std::wstring m_vr_preset_name{L"vr"};
+    CVarPresetApplier m_vr_preset{}; // Game thread only
+
+    PresetTuner m_tuner{}; // Game thread only
+    CVarPresetApplier m_tuner_applier{};
+    bool m_tuner_pending_apply{false};
+
+    CVarRegistry m_cvar_registry{{
+        {L"r.InGameUI.FixedWidth", &m_cvars.r_InGameUI_FixedWidth, true},
+        {L"r.InGameUI.FixedHeight", &m_cvars.r_InGameUI_FixedHeight, true},
+    }};
+
+    int32_t* m_system_resolution{nullptr};
+    ResolutionPublisher m_system_resolution_publisher{}; // Game thread only
+    uint32_t m_frame_index{0};
+    uint32_t m_stats_log_frames{900}; // Stats_Log_Frames, 0 turns the periodic report off
+    uint32_t m_upload_trim_frames{300}; // Upload_Trim_Idle_Frames, D3D12 only
+
+    UIPresentWork m_ui_work{}; // Present thread only
+
+    struct {
+        std::optional<std::chrono::steady_clock::time_point> reset_time{};
+        std::chrono::microseconds last_latency{};
+        uint32_t count{0};
+    } m_reset_stats{};
+
+    std::unique_ptr<RendererBase> m_renderer{};
+    void (FF7Plugin::*m_present_fn)(){&FF7Plugin::select_renderer};
+
+    // Runs on the first present only, after this on_present goes straight to present<T>
+    void select_renderer() {
+        const auto renderer_data = API::get()->param()->renderer;
+
+        switch (renderer_data->renderer_type) {
+        case UEVR_RENDERER_D3D11:
+            m_renderer = std::make_unique<Renderer<RendererType::D3D11>>(renderer_data);
+            m_present_fn = &FF7Plugin::present<RendererType::D3D11>;
+            break;
+        case UEVR_RENDERER_D3D12: {
+            auto renderer = std::make_unique<Renderer<RendererType::D3D12>>(renderer_data);
+            renderer->set_upload_trim_frames(m_upload_trim_frames);
+            m_renderer = std::move(renderer);
+            m_present_fn = &FF7Plugin::present<RendererType::D3D12>;
+            break;
+        }
+        default:
+            API::get()->log_error("Unknown renderer type %d, GPU work is disabled", renderer_data->renderer_type);
+            m_renderer = std::make_unique<Renderer<RendererType::Null>>();
+            m_present_fn = &FF7Plugin::present<RendererType::Null>;
+            break;
         }
 
-        const auto ui_render_target = API::StereoHook::get_ui_render_target();
+        (this->*m_present_fn)();
+    }
 
-        if (ui_render_target == nullptr) {
-            if (rt->data.texture == m_last_ui_tex && m_last_engine_ui_tex != nullptr) {
-                rt->data.texture = m_last_engine_ui_tex;
-                //rt->data.srt_texture = m_last_engine_ui_srt;
-            }
+    template <RendererType T>
+    void present() {
+        auto& renderer = static_cast<Renderer<T>&>(*m_renderer);
+
+        // Presents still happen while the renderer can't do anything, dynamic resolution and the tuner need all of them
+        update_frame_time();
 
-            m_last_ui_tex = nullptr;
-            m_last_engine_ui_tex = nullptr;
-            m_last_engine_ui_srt = nullptr;
+        if (!renderer.begin_frame()) {
+            // Command contexts are still being rebuilt after a device reset, try again next present
             return;
         }
 
-        if (rt->data.texture != ui_render_target) {
-            if (rt->data.texture != m_last_ui_tex) {
-                m_ui_tex_to_clear = rt->data.texture;
-                m_last_engine_ui_tex = rt->data.texture;
-                m_last_engine_ui_srt = rt->data.srt_texture;
-            }
-            
-            rt->data.texture = ui_render_target;
-            //rt->data.srt_texture = m_last_engine_ui_tex;
+        ++m_frame_index;
+
+        consume_gpu_work();
+
+        if (m_reset_stats.reset_time) {
+            const auto now = std::chrono::steady_clock::now();
+            m_reset_stats.last_latency = std::chrono::duration_cast<std::chrono::microseconds>(now - *m_reset_stats.reset_time);
+            m_reset_stats.reset_time.reset();
+
+            API::get()->log_info("Device reset to first frame took %.3fms", (double)m_reset_stats.last_latency.count() / 1000.0);
         }
 
-        m_last_ui_tex = ui_render_target;
-    }
+        UIPresentWork::Targets targets{};
+        targets.clear = get_native_resource(m_ui_tex_to_clear);
 
-private:
-    Patch::Ptr m_light_flagspatch{};
+        if (m_ui_work.get_config().snapshots) {
+            targets.ui = get_native_resource(API::StereoHook::get_ui_render_target());
+        }
 
-    std::recursive_mutex m_present_mutex{};
+        if (m_ui_work.get_config().probe) {
+            targets.draw = get_native_resource(m_ui_draw_target.load(std::memory_order_relaxed));
+        }
 
-    API::FRHITexture2D* m_last_engine_ui_tex{nullptr}; // The engine's render target
-    API::FRHITexture2D* m_last_engine_ui_srt{nullptr}; // The engine's render target
+        // Keeps asking for the clear until the texture has a native resource
+        if (targets.clear != nullptr) {
+            m_ui_tex_to_clear = nullptr;
+        }
 
-    API::FRHITexture2D* m_ui_tex_to_clear{nullptr};
-    API::FRHITexture2D* m_last_ui_tex{nullptr}; // Our render target we made
+        const auto result = m_ui_work.run(renderer, targets, m_frame_index);
 
-    struct {
-        bool initialized{false};
-        bool dirty{false};
-        API::IConsoleVariable* r_InGameUI_FixedWidth{nullptr};
-        API::IConsoleVariable* r_InGameUI_FixedHeight{nullptr};
-    } m_cvars{};
+        if (result.empty_changed) {
+            const auto& stats = m_ui_work.get_empty_stats();
+            API::get()->log_info("In-game UI is now %s (frame %llu, %.1f%% empty this session, %u clears skipped)",
+                stats.latest->empty ? "empty" : "visible", (unsigned long long)stats.latest->frame,
+                stats.get_empty_ratio() * 100.0f, m_ui_work.get_skipped_clears());
+        }
 
-    int32_t* m_system_resolution{nullptr};
-    uint32_t m_frame_index{0};
+        renderer.end_frame();
 
-    std::unique_ptr<DirectX::DX12::GraphicsMemory> m_graphics_memory{};
-    d3d12::CommandContext m_d3d12_commands[3]{};
-    d3d12::TextureContext m_d3d12_ui_tex{};
+        if (m_stats_log_frames > 0 && m_frame_index % m_stats_log_frames == 0) {
+            log_gpu_timings();
+            log_handoff_stats();
+            log_ui_snapshot();
+        }
+    }
 
+    static void* get_native_resource(API::FRHITexture2D* texture) {
+        return texture != nullptr ? texture->get_native_resource() : nullptr;
+    }
 
-    void init_d3d12() {
-        m_d3d12_ui_tex.reset();
+    void update_frame_time() {
+        const auto now = std::chrono::steady_clock::now();
+        const auto last = std::exchange(m_last_present, now);
 
-        if (m_graphics_memory == nullptr) {
-            auto device = (ID3D12Device*)API::get()->param()->renderer->device;
-            m_graphics_memory = std::make_unique<DirectX::DX12::GraphicsMemory>(device);
+        if (!API::get()->param()->vr->is_hmd_active()) {
+            return;
         }
 
-        for (auto& command_context : m_d3d12_commands) {
-            auto device = (ID3D12Device*)API::get()->param()->renderer->device;
-            if (command_context.cmd_list.Get() == nullptr) {
-                command_context.setup(device, L"FF7Plugin");
+        const auto frame_ms = std::chrono::duration<float, std::milli>(now - last).count();
+        m_last_present_ms.store(frame_ms, std::memory_order_relaxed);
+
+        if (m_dynamic_resolution.add_sample(frame_ms)) {
+            m_system_resolution_scale.store(m_dynamic_resolution.get_scale(), std::memory_order_relaxed);
+            const auto& controller = m_dynamic_resolution.get_controller();
+            API::get()->log_info("System resolution scale %.2f (%.2fms average against %.2fms)",
+                m_dynamic_resolution.get_scale(), controller.get_stats().last_average_ms, controller.get_target_ms());
+        }
+    }
+
+    void log_gpu_timings() const {
+        const auto& timings = m_renderer->get_gpu_timings();
+
+        for (size_t i = 0; i < timings.size(); ++i) {
+            const auto& timing = timings[i];
+
+            if (timing.frame == 0) {
+                continue;
             }
+
+            API::get()->log_info("[GPU] %s: %.2fus GPU, %.2fus CPU (frame %llu)",
+                get_gpu_op_name((GpuOp)i), timing.gpu_us, timing.cpu_us, (unsigned long long)timing.frame);
         }
     }
 
-    void on_device_reset() override {
-        std::scoped_lock _{m_present_mutex};
+    void log_handoff_stats() const {
+        if (m_handoff_stats.count == 0) {
+            return;
+        }
+
+        API::get()->log_info("[Handoff] %u items, %.1fus average, %lldus max, %u replaced before the present thread saw them",
+            m_handoff_stats.count, (double)m_handoff_stats.total.count() / (double)m_handoff_stats.count,
+            (long long)m_handoff_stats.max.count(), m_gpu_work.num_replaced());
+    }
+
+    // What the latest UI snapshot looked like, all the snapshots are used for so far
+    void log_ui_snapshot() {
+        if (!m_ui_work.get_config().snapshots) {
+            return;
+        }
 
-        if (API::get()->param()->renderer->renderer_type == UEVR_RENDERER_D3D12) {
-            for (auto& command_context : m_d3d12_commands) {
-                command_context.reset();
+        const auto view = get_ui_snapshot();
+
+        if (!view) {
+            API::get()->log_info("[Snapshot] No UI snapshot has landed yet");
+            return;
+        }
+
+        if (const auto coverage = get_alpha_coverage(*view); coverage) {
+            API::get()->log_info("[Snapshot] UI %ux%u from frame %llu (%u frames old), %.1f%% covered",
+                view->width, view->height, (unsigned long long)view->frame, m_frame_index - (uint32_t)view->frame, *coverage * 100.0f);
+        } else {
+            API::get()->log_info("[Snapshot] UI %ux%u from frame %llu, format %u",
+                view->width, view->height, (unsigned long long)view->frame, (uint32_t)view->format);
+        }
+    }
+
+    void consume_gpu_work() {
+        const auto now = std::chrono::steady_clock::now();
+
+        if (auto item = m_gpu_work.pop()) {
+            const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(now - item->published);
+            m_handoff_stats.last = latency;
+            m_handoff_stats.max = std::max(m_handoff_stats.max, latency);
+            m_handoff_stats.total += latency;
+            ++m_handoff_stats.count;
+
+            switch (item->type) {
+            case GpuWorkItem::Type::ClearUI:
+                // The swap only asks for a clear when a render target changed hands
+                m_ui_tex_to_clear = item->texture;
+                break;
+            default:
+                break;
             }
+        }
+    }
+
+    void on_device_reset() override {
+        m_reset_stats.reset_time = std::chrono::steady_clock::now();
+        ++m_reset_stats.count;
+        m_dynamic_resolution.reset();
+        m_system_resolution_scale.store(m_dynamic_resolution.get_scale(), std::memory_order_relaxed);
 
-            m_graphics_memory.reset();
+        if (m_renderer != nullptr) {
+            m_renderer->on_device_reset();
         }
     }
 };
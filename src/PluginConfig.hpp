@@ -0,0 +1,102 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// The plugin's own settings, one "Key=value" per line like UEVR's config.txt, # and ; start comments.
+// Lives in the persistent dir as ff7plugin.txt and is read once at initialize.
+// A missing file or key keeps the default the caller passes in.
+class PluginConfig {
+public:
+    static PluginConfig load(const std::filesystem::path& path) {
+        PluginConfig out{};
+        std::ifstream file{path};
+        std::string line{};
+
+        while (std::getline(file, line)) {
+            const auto view = trim(line);
+
+            if (view.empty() || view[0] == '#' || view[0] == ';') {
+                continue;
+            }
+
+            const auto eq = view.find('=');
+
+            if (eq == std::string_view::npos) {
+                continue;
+            }
+
+            const auto key = trim(view.substr(0, eq));
+
+            if (!key.empty()) {
+                out.m_values.insert_or_assign(std::string{key}, std::string{trim(view.substr(eq + 1))});
+            }
+        }
+
+        return out;
+    }
+
+    std::optional<std::string_view> get(std::string_view key) const {
+        const auto it = m_values.find(key);
+        return it != m_values.end() ? std::optional<std::string_view>{it->second} : std::nullopt;
+    }
+
+    bool get_bool(std::string_view key, bool default_value) const {
+        const auto value = get(key);
+
+        if (!value) {
+            return default_value;
+        }
+
+        if (*value == "true" || *value == "1") {
+            return true;
+        }
+
+        if (*value == "false" || *value == "0") {
+            return false;
+        }
+
+        return default_value;
+    }
+
+    template <typename T>
+    T get_number(std::string_view key, T default_value) const {
+        const auto value = get(key);
+
+        if (!value) {
+            return default_value;
+        }
+
+        T out{};
+        const auto [end, ec] = std::from_chars(value->data(), value->data() + value->size(), out);
+        return ec == std::errc{} && end == value->data() + value->size() ? out : default_value;
+    }
+
+    size_t size() const { return m_values.size(); }
+
+private:
+    struct Hash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    static std::string_view trim(std::string_view s) {
+        const auto first = s.find_first_not_of(" \t\r");
+
+        if (first == std::string_view::npos) {
+            return {};
+        }
+
+        return s.substr(first, s.find_last_not_of(" \t\r") - first + 1);
+    }
+
+    std::unordered_map<std::string, std::string, Hash, std::equal_to<>> m_values{};
+};
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "CVarPreset.hpp"
+
+// Searches a space of cvar values for the highest quality configuration that still holds a frame time target.
+// Starts from the lowest value of every cvar and raises them one step at a time, round robin in the order they
+// were listed. Each configuration runs for warmup_samples that are thrown away (shader and streaming hitches),
+// then measure_samples decide: over the target and the step is undone and that cvar isn't raised again.
+// No clocks or API calls in here, a recorded timing trace replayed through add_sample() gives the same result.
+class PresetTuner {
+public:
+    // values go from lowest to highest quality
+    struct Dimension {
+        std::wstring name{};
+        std::vector<std::wstring> values{};
+    };
+
+    struct Config {
+        float target_ms{11.111f};
+        float tolerance{1.02f};
+        uint32_t warmup_samples{90};
+        uint32_t measure_samples{180};
+    };
+
+    struct Sample {
+        float present_ms{0.0f}; // present to present
+        float tick_ms{0.0f};    // engine tick delta
+    };
+
+    struct Stats {
+        uint32_t trials{0};
+        uint32_t measured{0}; // trials that ran to the end
+        uint32_t accepted{0};
+        uint32_t rejected{0};
+        float last_present_ms{0.0f};
+        float last_tick_ms{0.0f};
+    };
+
+    enum class State : uint8_t {
+        Idle,
+        Running,
+        Done,
+    };
+
+    // One cvar per line, its name followed by the values to try, lowest quality first:
+    //   r.Shadow.MaxResolution 512 1024 2048
+    // # and ; start comments
+    static std::vector<Dimension> load_space(const std::filesystem::path& path) {
+        std::vector<Dimension> out{};
+        std::wifstream file{path};
+        std::wstring line{};
+
+        while (std::getline(file, line)) {
+            std::wistringstream stream{line};
+            Dimension dim{};
+
+            if (!(stream >> dim.name) || dim.name[0] == L'#' || dim.name[0] == L';') {
+                continue;
+            }
+
+            for (std::wstring value{}; stream >> value;) {
+                dim.values.push_back(value);
+            }
+
+            if (!dim.values.empty()) {
+                out.push_back(std::move(dim));
+            }
+        }
+
+        return out;
+    }
+
+    // The first configuration to apply is the lowest one, get_preset() has it right after this
+    void start(std::vector<Dimension> space, const Config& config) {
+        m_space = std::move(space);
+        m_config = config;
+        m_config.measure_samples = (std::max)(m_config.measure_samples, 1u);
+        m_levels.assign(m_space.size(), 0);
+        m_frozen.assign(m_space.size(), false);
+        m_trial = m_levels;
+        m_trial_dim = NO_DIMENSION;
+        m_cursor = 0;
+        m_stats = {};
+        m_state = m_space.empty() ? State::Done : State::Running;
+        begin_trial();
+    }
+
+    void stop() {
+        m_state = State::Idle;
+    }
+
+    // Throws away what the current configuration has measured so far, warmup included.
+    // For when the samples stopped describing it, like the HMD going away halfway through.
+    void restart_trial() {
+        m_count = 0;
+        m_present_sum = 0.0;
+        m_tick_sum = 0.0;
+    }
+
+    // Returns true when the configuration to apply (get_preset()) changed
+    bool add_sample(const Sample& sample) {
+        if (m_state != State::Running) {
+            return false;
+        }
+
+        // Loading screens and the like say nothing about the configuration
+        if (!(sample.present_ms > 0.0f) || !(sample.tick_ms > 0.0f) || sample.present_ms > 250.0f || sample.tick_ms > 250.0f) {
+            return false;
+        }
+
+        if (++m_count <= m_config.warmup_samples) {
+            return false;
+        }
+
+        m_present_sum += sample.present_ms;
+        m_tick_sum += sample.tick_ms;
+
+        if (m_count < m_config.warmup_samples + m_config.measure_samples) {
+            return false;
+        }
+
+        return end_trial();
+    }
+
+    State get_state() const { return m_state; }
+    bool is_running() const { return m_state == State::Running; }
+    const Stats& get_stats() const { return m_stats; }
+    const Config& get_config() const { return m_config; }
+
+    // Index into each dimension's values, of the configuration being measured (or the result once done)
+    const std::vector<uint32_t>& get_levels() const { return m_trial; }
+
+    CVarPreset get_preset(std::wstring name) const {
+        CVarPreset out{};
+        out.name = std::move(name);
+
+        for (size_t i = 0; i < m_space.size(); ++i) {
+            out.values.push_back(CVarPreset::Value{m_space[i].name, m_space[i].values[m_trial[i]]});
+        }
+
+        return out;
+    }
+
+private:
+    static constexpr size_t NO_DIMENSION = ~(size_t)0;
+
+    void begin_trial() {
+        restart_trial();
+        ++m_stats.trials;
+    }
+
+    bool end_trial() {
+        m_stats.last_present_ms = (float)(m_present_sum / m_config.measure_samples);
+        m_stats.last_tick_ms = (float)(m_tick_sum / m_config.measure_samples);
+        ++m_stats.measured;
+
+        const auto limit = m_config.target_ms * m_config.tolerance;
+        const auto pass = m_stats.last_present_ms <= limit && m_stats.last_tick_ms <= limit;
+
+        // The lowest configuration is kept either way, there's nothing below it to fall back to
+        if (m_trial_dim != NO_DIMENSION) {
+            if (pass) {
+                m_levels = m_trial;
+                ++m_stats.accepted;
+            } else {
+                m_frozen[m_trial_dim] = true;
+                ++m_stats.rejected;
+            }
+        }
+
+        const auto previous = m_trial;
+
+        if (const auto next = find_next(); next != NO_DIMENSION) {
+            m_trial = m_levels;
+            ++m_trial[next];
+            m_trial_dim = next;
+            begin_trial();
+        } else {
+            m_trial = m_levels;
+            m_trial_dim = NO_DIMENSION;
+            m_state = State::Done;
+        }
+
+        return m_trial != previous;
+    }
+
+    // Next dimension after the last one tried that can still go up
+    size_t find_next() {
+        for (size_t i = 0; i < m_space.size(); ++i) {
+            const auto dim = (m_cursor + i) % m_space.size();
+
+            if (!m_frozen[dim] && m_levels[dim] + 1 < m_space[dim].values.size()) {
+                m_cursor = dim + 1;
+                return dim;
+            }
+        }
+
+        return NO_DIMENSION;
+    }
+
+    std::vector<Dimension> m_space{};
+    std::vector<uint32_t> m_levels{}; // best configuration that passed so far
+    std::vector<uint32_t> m_trial{};
+    std::vector<bool> m_frozen{};
+    Config m_config{};
+    Stats m_stats{};
+    State m_state{State::Idle};
+    size_t m_trial_dim{NO_DIMENSION};
+    size_t m_cursor{0};
+    uint32_t m_count{0};
+    double m_present_sum{0.0};
+    double m_tick_sum{0.0};
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#ifdef _WIN32
+#include <dxgiformat.h>
+#else
+// Just enough of dxgiformat.h for the Null renderer and the tests, same values
+enum DXGI_FORMAT : uint32_t {
+    DXGI_FORMAT_UNKNOWN = 0,
+    DXGI_FORMAT_R10G10B10A2_TYPELESS = 23,
+    DXGI_FORMAT_R10G10B10A2_UNORM = 24,
+    DXGI_FORMAT_R8G8B8A8_TYPELESS = 27,
+    DXGI_FORMAT_R8G8B8A8_UNORM = 28,
+    DXGI_FORMAT_R8G8B8A8_UNORM_SRGB = 29,
+    DXGI_FORMAT_B8G8R8A8_UNORM = 87,
+    DXGI_FORMAT_B8G8R8A8_TYPELESS = 90,
+    DXGI_FORMAT_B8G8R8A8_UNORM_SRGB = 91,
+};
+#endif
+
+// CPU-side view of a completed GPU readback.
+// Only valid until the owning ring is unmapped or the slot gets reused.
+struct ReadbackView {
+    const uint8_t* data{nullptr};
+    uint32_t width{0};
+    uint32_t height{0};
+    uint32_t row_pitch{0}; // bytes, NOT width * bpp, rows are padded
+    DXGI_FORMAT format{DXGI_FORMAT_UNKNOWN};
+    uint64_t frame{0}; // frame the copy was queued in
+
+    const uint8_t* row(uint32_t y) const {
+        return data + (size_t)y * row_pitch;
+    }
+
+    template <typename T>
+    const T* row_as(uint32_t y) const {
+        return (const T*)row(y);
+    }
+};
+
+// Fraction of the snapshot with any alpha, checking every step-th pixel on both axes.
+// nullopt for formats this doesn't know the alpha channel of.
+inline std::optional<float> get_alpha_coverage(const ReadbackView& view, uint32_t step = 4) {
+    if (view.data == nullptr || view.width == 0 || view.height == 0 || step == 0) {
+        return std::nullopt;
+    }
+
+    uint32_t alpha_mask{};
+
+    switch (view.format) {
+    case DXGI_FORMAT_R8G8B8A8_TYPELESS:
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+    case DXGI_FORMAT_B8G8R8A8_TYPELESS:
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        alpha_mask = 0xFF000000;
+        break;
+    case DXGI_FORMAT_R10G10B10A2_TYPELESS:
+    case DXGI_FORMAT_R10G10B10A2_UNORM:
+        alpha_mask = 0xC0000000;
+        break;
+    default:
+        return std::nullopt;
+    }
+
+    uint64_t sampled = 0;
+    uint64_t covered = 0;
+
+    for (uint32_t y = 0; y < view.height; y += step) {
+        const auto pixels = view.row_as<uint32_t>(y);
+
+        for (uint32_t x = 0; x < view.width; x += step) {
+            covered += (pixels[x] & alpha_mask) != 0 ? 1 : 0;
+            ++sampled;
+        }
+    }
+
+    return (float)((double)covered / (double)sampled);
+}
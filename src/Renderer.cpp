@@ -0,0 +1,284 @@
+#include <d3d11_1.h>
+#include <spdlog/spdlog.h>
+
+#include "Renderer.hpp"
+
+using namespace uevr;
+
+namespace {
+HRESULT clear_d3d11_rt(ID3D11Device* device, ID3D11Texture2D* texture, const float* clear_color, const ClearRects& rects = {}, std::optional<DXGI_FORMAT> format = std::nullopt) {
+    // Create a temporary render target view
+    // This is meant to be called infrequently so it's fine to create and destroy the view every time
+    d3d11::ComPtr<ID3D11RenderTargetView> rtv{};
+
+    if (format) {
+        D3D11_RENDER_TARGET_VIEW_DESC rtv_desc{};
+        rtv_desc.Format = *format;
+        rtv_desc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
+        rtv_desc.Texture2D.MipSlice = 0;
+        if (auto result = device->CreateRenderTargetView(texture, &rtv_desc, &rtv); FAILED(result)) {
+            return result;
+        }
+    } else {
+        if (auto result = device->CreateRenderTargetView(texture, nullptr, &rtv); FAILED(result)) {
+            format = DXGI_FORMAT_B8G8R8A8_UNORM;
+
+            D3D11_RENDER_TARGET_VIEW_DESC rtv_desc{};
+            rtv_desc.Format = *format;
+            rtv_desc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
+            rtv_desc.Texture2D.MipSlice = 0;
+            if (auto result = device->CreateRenderTargetView(texture, &rtv_desc, &rtv); FAILED(result)) {
+                return result;
+            }
+        }
+    }
+
+    // Clear the render target
+    d3d11::ComPtr<ID3D11DeviceContext> context{nullptr};
+    device->GetImmediateContext(&context);
+
+    // ClearView needs the 11.1 runtime, anything older gets the full clear
+    d3d11::ComPtr<ID3D11DeviceContext1> context1{nullptr};
+
+    if (rects.count > 0 && SUCCEEDED(context.As(&context1))) {
+        D3D11_RECT d3d11_rects[MAX_CLEAR_RECTS]{};
+
+        for (uint32_t i = 0; i < rects.count; ++i) {
+            d3d11_rects[i] = D3D11_RECT{rects.rects[i].left, rects.rects[i].top, rects.rects[i].right, rects.rects[i].bottom};
+        }
+
+        context1->ClearView(rtv.Get(), clear_color, d3d11_rects, rects.count);
+    } else {
+        context->ClearRenderTargetView(rtv.Get(), clear_color);
+    }
+
+    return S_OK;
+}
+
+// The engine UI textures are always in this state by the time we see them on present
+constexpr auto D3D12_UI_TEXTURE_STATE = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+}
+
+// D3D11
+bool Renderer<RendererType::D3D11>::begin_frame() {
+    if (m_context == nullptr) {
+        get_device()->GetImmediateContext(&m_context);
+        m_profiler.get_queries().setup(get_device());
+    }
+
+    m_profiler.begin_frame();
+    return true;
+}
+
+void Renderer<RendererType::D3D11>::clear_ui(void* native_resource, const float* color, uint32_t, const DirtyRects* dirty) {
+    GpuProfiler<d3d11::TimestampQueries>::Scope _{m_profiler, GpuOp::ClearUI, m_context.Get()};
+
+    const auto texture = (ID3D11Texture2D*)native_resource;
+    ClearRects rects{};
+
+    if (dirty != nullptr) {
+        D3D11_TEXTURE2D_DESC desc{};
+        texture->GetDesc(&desc);
+        rects = dirty->build(native_resource, desc.Width, desc.Height, UI_ALPHA_PROBE_TILE);
+    }
+
+    if (FAILED(clear_d3d11_rt(get_device(), texture, color, rects))) {
+        API::get()->log_error("Failed to clear D3D11 render target");
+    }
+}
+
+void Renderer<RendererType::D3D11>::snapshot_ui(void* native_resource, uint32_t frame) {
+    GpuProfiler<d3d11::TimestampQueries>::Scope _{m_profiler, GpuOp::SnapshotUI, m_context.Get()};
+
+    m_ui_readback.queue_copy(get_device(), (ID3D11Texture2D*)native_resource, frame);
+}
+
+void Renderer<RendererType::D3D11>::probe_ui(void* native_resource, uint32_t frame) {
+    GpuProfiler<d3d11::TimestampQueries>::Scope _{m_profiler, GpuOp::ProbeUI, m_context.Get()};
+
+    m_ui_probe.queue(get_device(), (ID3D11Texture2D*)native_resource, frame);
+}
+
+void Renderer<RendererType::D3D11>::end_frame() {
+    m_profiler.end_frame();
+}
+
+void Renderer<RendererType::D3D11>::on_device_reset() {
+    m_ui_readback.reset();
+    m_ui_probe.reset();
+    m_profiler.reset();
+    m_profiler.get_queries().reset();
+    m_context.Reset();
+}
+
+std::optional<ReadbackView> Renderer<RendererType::D3D11>::map_ui_snapshot() {
+    return m_ui_readback.map_latest();
+}
+
+// D3D12
+bool Renderer<RendererType::D3D12>::begin_frame() {
+    if (m_prewarm.valid()) {
+        if (m_prewarm.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+            return false;
+        }
+
+        m_prewarm.get();
+    }
+
+    m_deferred.collect();
+    m_ui_tex.retire(m_deferred);
+
+    // The prewarm used whatever device was current when the reset came in,
+    // if it has been recreated since then everything built on the old one has to go
+    if (m_device != nullptr && m_device != get_device()) {
+        for (auto& command_context : m_commands) {
+            command_context.retire(m_deferred);
+        }
+
+        m_profiler.get_queries().retire(m_deferred);
+        m_ui_readback.retire(m_deferred);
+        m_ui_probe.retire(m_deferred);
+        m_device = nullptr;
+    }
+
+    for (auto& command_context : m_commands) {
+        if (command_context.cmd_list.Get() == nullptr) {
+            command_context.setup(get_device(), L"FF7Plugin");
+        }
+    }
+
+    if (!m_profiler.get_queries().is_setup()) {
+        m_profiler.get_queries().setup(get_device(), get_command_queue());
+    }
+
+    m_device = get_device();
+
+    m_profiler.begin_frame();
+    return true;
+}
+
+void Renderer<RendererType::D3D12>::clear_ui(void* native_resource, const float* color, uint32_t frame, const DirtyRects* dirty) {
+    auto& command_context = m_commands[frame % 3];
+
+    command_context.wait(2000);
+
+    m_ui_tex.setup(get_device(), (ID3D12Resource*)native_resource, DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_FORMAT_B8G8R8A8_UNORM);
+
+    ClearRects rects{};
+
+    if (dirty != nullptr) {
+        const auto desc = ((ID3D12Resource*)native_resource)->GetDesc();
+        rects = dirty->build(native_resource, (uint32_t)desc.Width, desc.Height, UI_ALPHA_PROBE_TILE);
+    }
+
+    D3D12_RECT d3d12_rects[MAX_CLEAR_RECTS]{};
+
+    for (uint32_t i = 0; i < rects.count; ++i) {
+        d3d12_rects[i] = D3D12_RECT{rects.rects[i].left, rects.rects[i].top, rects.rects[i].right, rects.rects[i].bottom};
+    }
+
+    {
+        GpuProfiler<d3d12::TimestampQueries>::Scope _{m_profiler, GpuOp::ClearUI, command_context.cmd_list.Get()};
+        command_context.clear_rtv(m_ui_tex, color, D3D12_UI_TEXTURE_STATE, rects.count, rects.count > 0 ? d3d12_rects : nullptr);
+    }
+
+    command_context.execute(get_command_queue());
+}
+
+void Renderer<RendererType::D3D12>::snapshot_ui(void* native_resource, uint32_t frame) {
+    const auto src = (ID3D12Resource*)native_resource;
+    auto command_context = m_ui_readback.begin_copy(get_device(), src, frame);
+
+    if (command_context == nullptr) {
+        return;
+    }
+
+    {
+        GpuProfiler<d3d12::TimestampQueries>::Scope _{m_profiler, GpuOp::SnapshotUI, command_context->cmd_list.Get()};
+        m_ui_readback.record_copy(src, frame, D3D12_UI_TEXTURE_STATE);
+    }
+
+    m_ui_readback.submit(get_command_queue(), frame);
+}
+
+void Renderer<RendererType::D3D12>::probe_ui(void* native_resource, uint32_t frame) {
+    const auto src = (ID3D12Resource*)native_resource;
+    auto command_context = m_ui_probe.begin(get_device(), frame);
+
+    if (command_context == nullptr) {
+        return;
+    }
+
+    // D3D12_UI_TEXTURE_STATE includes NON_PIXEL_SHADER_RESOURCE, the probe can read the texture as is
+    {
+        GpuProfiler<d3d12::TimestampQueries>::Scope _{m_profiler, GpuOp::ProbeUI, command_context->cmd_list.Get()};
+        m_ui_probe.record(*command_context, get_device(), src, frame);
+    }
+
+    m_ui_probe.submit(get_command_queue(), frame);
+}
+
+void Renderer<RendererType::D3D12>::end_frame() {
+    // Submits the timestamp resolve, has to happen after all of the profiled work was executed
+    m_profiler.end_frame();
+
+    // No-op unless something allocated from it this frame
+    m_upload.on_present(get_command_queue());
+
+    // Everything retired this frame gets freed once the GPU passes this point
+    m_deferred.signal(get_command_queue());
+}
+
+void Renderer<RendererType::D3D12>::on_device_reset() {
+    // A previous rebuild could still be running, it must finish before we touch the contexts again
+    if (m_prewarm.valid()) {
+        m_prewarm.wait();
+    }
+
+    const auto device = get_device();
+    const auto queue = get_command_queue();
+
+    for (auto& command_context : m_commands) {
+        command_context.retire(m_deferred);
+    }
+
+    // Its views are of the engine's UI texture, which the reset may have released. clear_ui makes new ones anyway.
+    m_ui_tex.retire(m_deferred);
+
+    // The readback buffers and the probe's pipeline, result buffer and descriptors are all our own
+    // and only depend on the device, a reset that keeps it keeps them
+    if (device != m_device) {
+        m_ui_readback.retire(m_deferred);
+        m_ui_probe.retire(m_deferred);
+    }
+
+    m_profiler.reset();
+    m_profiler.get_queries().retire(m_deferred);
+
+    // One fence wait for everything instead of up to 2 seconds per command context.
+    // The fence itself is dropped too in case the device changes.
+    m_deferred.flush(queue, 2000);
+    m_deferred.reset();
+    m_upload.reset();
+    m_device = nullptr;
+
+    if (device == nullptr) {
+        return;
+    }
+
+    // CommandContext::setup only creates objects on the device, which is free threaded,
+    // so the next present doesn't have to do any of the creation work itself.
+    // The worker only gets the device and queue from here, m_data belongs to the present thread.
+    m_prewarm = std::async(std::launch::async, [this, device, queue]() {
+        for (auto& command_context : m_commands) {
+            command_context.setup(device, L"FF7Plugin");
+        }
+
+        m_profiler.get_queries().setup(device, queue);
+        m_device = device;
+    });
+}
+
+std::optional<ReadbackView> Renderer<RendererType::D3D12>::map_ui_snapshot() {
+    return m_ui_readback.map_latest();
+}
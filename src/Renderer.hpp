@@ -0,0 +1,151 @@
+#pragma once
+
+#include <future>
+#include <optional>
+#include <utility>
+#include <cstdint>
+
+#include "DirtyRects.hpp"
+#include "Readback.hpp"
+#include "GpuProfiler.hpp"
+#include "UIAlphaProbe.hpp"
+
+// Only the Null backend builds outside of Windows, which is what the tests run against
+#ifdef _WIN32
+#include <d3d11.h>
+#include <d3d12.h>
+
+#include "uevr/API.hpp"
+
+#include "d3d11/AlphaProbe.hpp"
+#include "d3d11/ReadbackRing.hpp"
+#include "d3d11/TimestampQueries.hpp"
+#include "d3d12/AlphaProbe.hpp"
+#include "d3d12/CommandContext.hpp"
+#include "d3d12/TextureContext.hpp"
+#include "d3d12/ReadbackRing.hpp"
+#include "d3d12/UploadAllocator.hpp"
+#include "d3d12/DeferredRelease.hpp"
+#include "d3d12/TimestampQueries.hpp"
+#endif
+
+enum class RendererType : uint8_t {
+    D3D11,
+    D3D12,
+    Null, // no GPU work at all, used when there's no renderer we know how to drive
+};
+
+// Only the rarely called paths are virtual here.
+// The per-frame functions (begin_frame, clear_ui, snapshot_ui, probe_ui, end_frame) live on the
+// Renderer<T> specializations and get called directly from code templated on the backend,
+// which is picked once when the first frame comes in.
+struct RendererBase {
+    virtual ~RendererBase() = default;
+
+    virtual RendererType get_type() const = 0;
+    virtual void on_device_reset() = 0;
+    virtual std::optional<ReadbackView> map_ui_snapshot() = 0;
+    virtual const GpuOpTimings& get_gpu_timings() const = 0;
+};
+
+template <RendererType T>
+struct Renderer;
+
+#ifdef _WIN32
+template <>
+struct Renderer<RendererType::D3D11> final : public RendererBase {
+    Renderer(const UEVR_RendererData* data) : m_data{data} {}
+
+    RendererType get_type() const override { return RendererType::D3D11; }
+
+    bool begin_frame();
+    // Clears only the rects dirty has for native_resource if it trusts them, everything otherwise
+    void clear_ui(void* native_resource, const float* color, uint32_t frame, const DirtyRects* dirty = nullptr);
+    void snapshot_ui(void* native_resource, uint32_t frame);
+    void probe_ui(void* native_resource, uint32_t frame);
+    std::optional<UIAlphaResult> poll_ui_probe() { return m_ui_probe.poll(); }
+    void end_frame();
+
+    void on_device_reset() override;
+    std::optional<ReadbackView> map_ui_snapshot() override;
+    const GpuOpTimings& get_gpu_timings() const override { return m_profiler.get_timings(); }
+
+private:
+    ID3D11Device* get_device() const { return (ID3D11Device*)m_data->device; }
+
+    const UEVR_RendererData* m_data{nullptr};
+    d3d11::ComPtr<ID3D11DeviceContext> m_context{};
+    d3d11::ReadbackRing m_ui_readback{};
+    d3d11::AlphaProbe m_ui_probe{};
+    GpuProfiler<d3d11::TimestampQueries> m_profiler{};
+};
+
+template <>
+struct Renderer<RendererType::D3D12> final : public RendererBase {
+    Renderer(const UEVR_RendererData* data) : m_data{data} {}
+
+    RendererType get_type() const override { return RendererType::D3D12; }
+
+    // Returns false while the command contexts are still being rebuilt after a device reset
+    bool begin_frame();
+    // Clears only the rects dirty has for native_resource if it trusts them, everything otherwise
+    void clear_ui(void* native_resource, const float* color, uint32_t frame, const DirtyRects* dirty = nullptr);
+    void snapshot_ui(void* native_resource, uint32_t frame);
+    void probe_ui(void* native_resource, uint32_t frame);
+    std::optional<UIAlphaResult> poll_ui_probe() { return m_ui_probe.poll(); }
+    void end_frame();
+
+    void on_device_reset() override;
+    std::optional<ReadbackView> map_ui_snapshot() override;
+    const GpuOpTimings& get_gpu_timings() const override { return m_profiler.get_timings(); }
+
+    void set_upload_trim_frames(uint32_t frames) { m_upload.set_idle_frames_before_trim(frames); }
+
+private:
+    ID3D12Device* get_device() const { return (ID3D12Device*)m_data->device; }
+    ID3D12CommandQueue* get_command_queue() const { return (ID3D12CommandQueue*)m_data->command_queue; }
+
+    const UEVR_RendererData* m_data{nullptr};
+
+    d3d12::DeferredRelease m_deferred{};
+    d3d12::UploadAllocator m_upload{};
+    d3d12::CommandContext m_commands[3]{};
+    d3d12::TextureContext m_ui_tex{};
+    d3d12::ReadbackRing m_ui_readback{};
+    d3d12::AlphaProbe m_ui_probe{};
+    GpuProfiler<d3d12::TimestampQueries> m_profiler{};
+
+    // Rebuilds m_commands and the timestamp queries off the present thread after a device reset
+    std::future<void> m_prewarm{};
+    ID3D12Device* m_device{nullptr}; // what m_commands, the timestamp queries, the readback ring and the probe were created on, only touched once m_prewarm is done
+};
+#endif
+
+// Does nothing but count, lets the plugin logic run without a GPU
+template <>
+struct Renderer<RendererType::Null> final : public RendererBase {
+    RendererType get_type() const override { return RendererType::Null; }
+
+    bool begin_frame() { ++frames; return true; }
+    void clear_ui(void* native_resource, const float*, uint32_t, const DirtyRects* dirty = nullptr) {
+        ++clears;
+        rect_clears += dirty != nullptr && dirty->is_trusted(native_resource);
+    }
+    void snapshot_ui(void*, uint32_t) { ++snapshots; }
+    void probe_ui(void*, uint32_t) { ++probes; }
+    std::optional<UIAlphaResult> poll_ui_probe() { return std::exchange(probe_result, std::nullopt); }
+    void end_frame() {}
+
+    void on_device_reset() override { ++resets; }
+    std::optional<ReadbackView> map_ui_snapshot() override { return std::nullopt; }
+    const GpuOpTimings& get_gpu_timings() const override { return timings; }
+
+    GpuOpTimings timings{};
+    std::optional<UIAlphaResult> probe_result{}; // handed out by the next poll_ui_probe()
+    uint32_t frames{0};
+    uint32_t clears{0};
+    uint32_t rect_clears{0};
+    uint32_t snapshots{0};
+    uint32_t probes{0};
+    uint32_t resets{0};
+};
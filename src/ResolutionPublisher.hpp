@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "DynamicResolution.hpp"
+
+// Decides when a new resolution actually gets written to GSystemResolution.
+// Every write of a different size makes the engine reallocate its scene render targets, so a
+// requested size has to stay the same for settle_frames in a row before it is published, which
+// folds start-up transients and runs of tweaks into one write. Once published the value is only
+// written again if something else overwrote it in memory.
+// Called once per frame at the same point of the frame, that call is the frame boundary writes happen on.
+class ResolutionPublisher {
+public:
+    using Size = DynamicResolution::Size;
+
+    struct Config {
+        uint32_t settle_frames{15};
+    };
+
+    struct Stats {
+        uint32_t publishes{0};   // writes of a new size, one reallocation of the scene targets each
+        uint32_t coalesced{0};   // requested sizes that were replaced before they settled
+        uint32_t reasserts{0};   // writes because the value in memory no longer matched ours
+    };
+
+    void set_config(const Config& config) { m_config = config; }
+
+    // Forget what was published, the next settled size gets written again
+    void reset() {
+        m_published.reset();
+        m_pending.reset();
+        m_pending_frames = 0;
+        m_reasserts_since_publish = 0;
+    }
+
+    // Returns the size to write this frame, if any
+    std::optional<Size> update(const Size& requested, const Size& in_memory) {
+        if (requested.width == 0 || requested.height == 0) {
+            return std::nullopt;
+        }
+
+        if (!m_pending || !(*m_pending == requested)) {
+            if (m_pending && !(m_published && *m_published == *m_pending)) {
+                ++m_stats.coalesced;
+            }
+
+            m_pending = requested;
+            m_pending_frames = 0;
+        }
+
+        if (m_pending_frames < m_config.settle_frames) {
+            ++m_pending_frames;
+        }
+
+        if (m_published && *m_published == requested) {
+            if (in_memory == requested) {
+                return std::nullopt;
+            }
+
+            ++m_stats.reasserts;
+            ++m_reasserts_since_publish;
+            return requested;
+        }
+
+        if (m_pending_frames < m_config.settle_frames) {
+            // Keep what we had in place while the new size settles
+            if (m_published && !(in_memory == *m_published)) {
+                ++m_stats.reasserts;
+                ++m_reasserts_since_publish;
+                return m_published;
+            }
+
+            return std::nullopt;
+        }
+
+        m_published = requested;
+        m_reasserts_since_publish = 0;
+        ++m_stats.publishes;
+        return requested;
+    }
+
+    const std::optional<Size>& get_published() const { return m_published; }
+    const Stats& get_stats() const { return m_stats; }
+
+    // 0 right after update() returned a new size, counts the rewrites of that size from then on
+    uint32_t get_reasserts_since_publish() const { return m_reasserts_since_publish; }
+
+private:
+    Config m_config{};
+    Stats m_stats{};
+    std::optional<Size> m_published{};
+    std::optional<Size> m_pending{};
+    uint32_t m_pending_frames{0};
+    uint32_t m_reasserts_since_publish{0};
+};
@@ -0,0 +1,75 @@
+#include <mutex>
+
+#include <wrl.h>
+#include <d3dcompiler.h>
+#include <spdlog/spdlog.h>
+
+#include "UIAlphaProbe.hpp"
+
+namespace {
+// ORs one bit per UI_COVERAGE_GRID x UI_COVERAGE_GRID cell into result[0] (cells 0-31) and result[1] (cells 32-63)
+// for every cell with a pixel of non-zero alpha. The result has to be cleared to 0 before each dispatch.
+// Out of bounds loads return 0 so partial tiles at the edges need no special casing.
+constexpr char UI_ALPHA_PROBE_HLSL[] = R"(
+Texture2D<float4> ui_texture : register(t0);
+RWTexture2D<uint> result : register(u0);
+
+cbuffer Params : register(b0) {
+    uint2 num_tiles;
+};
+
+static const uint GRID = 8;
+
+groupshared uint any_alpha;
+
+[numthreads(8, 8, 1)]
+void main(uint3 id : SV_DispatchThreadID, uint3 group : SV_GroupID, uint gi : SV_GroupIndex) {
+    if (gi == 0) {
+        any_alpha = 0;
+    }
+
+    GroupMemoryBarrierWithGroupSync();
+
+    const uint2 base = id.xy * 4;
+    bool found = false;
+
+    [unroll] for (uint y = 0; y < 4; ++y) {
+        [unroll] for (uint x = 0; x < 4; ++x) {
+            found = found || ui_texture.Load(int3(base + uint2(x, y), 0)).a > 0.0;
+        }
+    }
+
+    if (found) {
+        any_alpha = 1;
+    }
+
+    GroupMemoryBarrierWithGroupSync();
+
+    if (gi == 0 && any_alpha != 0) {
+        const uint2 cell = group.xy * GRID / num_tiles;
+        const uint bit = cell.y * GRID + cell.x;
+        InterlockedOr(result[uint2(bit / 32, 0)], 1u << (bit % 32));
+    }
+}
+)";
+}
+
+ID3DBlob* get_ui_alpha_probe_bytecode() {
+    static Microsoft::WRL::ComPtr<ID3DBlob> bytecode{};
+    static std::once_flag once{};
+
+    std::call_once(once, []() {
+        Microsoft::WRL::ComPtr<ID3DBlob> errors{};
+
+        const auto hr = D3DCompile(UI_ALPHA_PROBE_HLSL, sizeof(UI_ALPHA_PROBE_HLSL) - 1, "UIAlphaProbe", nullptr, nullptr,
+                                   "main", "cs_5_0", D3DCOMPILE_OPTIMIZATION_LEVEL3, 0, &bytecode, &errors);
+
+        if (FAILED(hr)) {
+            spdlog::error("[UIAlphaProbe] Failed to compile probe shader: {}",
+                errors != nullptr ? (const char*)errors->GetBufferPointer() : "unknown error");
+            bytecode.Reset();
+        }
+    });
+
+    return bytecode.Get();
+}
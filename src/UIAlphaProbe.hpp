@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+
+#ifdef _WIN32
+#include <d3dcommon.h>
+#include <dxgiformat.h>
+#endif
+
+#include "DirtyRects.hpp"
+
+// Every thread of the probe checks a 4x4 block, a thread group of 8x8 covers this many pixels per side
+constexpr uint32_t UI_ALPHA_PROBE_TILE = 32;
+
+#ifdef _WIN32
+// cs_5_0 bytecode of the probe, compiled once on first use. nullptr if compilation failed.
+ID3DBlob* get_ui_alpha_probe_bytecode();
+
+// SRVs can't be created with a typeless format
+inline DXGI_FORMAT get_ui_alpha_probe_srv_format(DXGI_FORMAT format) {
+    switch (format) {
+    case DXGI_FORMAT_R8G8B8A8_TYPELESS:
+        return DXGI_FORMAT_R8G8B8A8_UNORM;
+    case DXGI_FORMAT_B8G8R8A8_TYPELESS:
+        return DXGI_FORMAT_B8G8R8A8_UNORM;
+    case DXGI_FORMAT_R10G10B10A2_TYPELESS:
+        return DXGI_FORMAT_R10G10B10A2_UNORM;
+    case DXGI_FORMAT_R16G16B16A16_TYPELESS:
+        return DXGI_FORMAT_R16G16B16A16_FLOAT;
+    default:
+        return format;
+    }
+}
+#endif
+
+struct UIAlphaResult {
+    uint64_t frame{0}; // frame the probe was queued in
+    const void* texture{nullptr}; // native resource that was probed, only for comparisons
+    uint64_t coverage{0}; // one bit per UI_COVERAGE_GRID cell with any alpha, see DirtyRects
+    bool empty{false};
+};
+
+inline uint32_t get_ui_alpha_probe_groups(uint32_t size) {
+    return (size + UI_ALPHA_PROBE_TILE - 1) / UI_ALPHA_PROBE_TILE;
+}
+
+// Emptiness of the UI over the whole session, fed with each probe result as it lands
+struct UIEmptyStats {
+    uint64_t probes{0};
+    uint64_t empty{0};
+    uint64_t transitions{0};
+    uint64_t streak{0}; // consecutive probes agreeing with the latest one
+    uint64_t longest_empty_streak{0};
+    std::optional<UIAlphaResult> latest{};
+
+    // Returns true if the UI went from empty to visible or the other way around
+    bool record(const UIAlphaResult& result) {
+        const auto changed = latest && latest->empty != result.empty;
+
+        ++probes;
+        streak = changed || !latest ? 1 : streak + 1;
+
+        if (changed) {
+            ++transitions;
+        }
+
+        if (result.empty) {
+            ++empty;
+            longest_empty_streak = (std::max)(longest_empty_streak, streak);
+        }
+
+        latest = result;
+        return changed;
+    }
+
+    float get_empty_ratio() const {
+        return probes > 0 ? (float)empty / (float)probes : 0.0f;
+    }
+};
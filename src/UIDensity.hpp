@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+// Where UEVR puts the UI quad, from UI_Size and UI_Distance in the game's config.txt.
+// The quad is UI_Size meters wide, its height follows the UI render target's aspect ratio.
+struct UIPlacement {
+    float size{2.0f};
+    float distance{2.0f};
+
+    // Missing keys keep their defaults, a missing file returns nullopt
+    static std::optional<UIPlacement> load(const std::filesystem::path& config_path) {
+        std::ifstream file{config_path};
+
+        if (!file) {
+            return std::nullopt;
+        }
+
+        UIPlacement out{};
+        std::string line{};
+
+        while (std::getline(file, line)) {
+            const auto eq = line.find('=');
+
+            if (eq == std::string::npos) {
+                continue;
+            }
+
+            const auto key = line.substr(0, eq);
+            const auto value = line.substr(eq + 1);
+
+            try {
+                if (key == "UI_Size") {
+                    out.size = std::stof(value);
+                } else if (key == "UI_Distance") {
+                    out.distance = std::stof(value);
+                }
+            } catch (...) {
+                continue;
+            }
+        }
+
+        return out;
+    }
+};
+
+// Smallest UI render resolution that still gives the display all the detail it can resolve,
+// given how much of the field of view the UI quad covers.
+struct UIDensity {
+    struct Input {
+        UIPlacement placement{};
+        float projection_x_scale{0.0f}; // [0][0] of the eye's UE projection matrix, 2 / (tan right - tan left)
+        float projection_y_scale{0.0f}; // [1][1], 2 / (tan up - tan down)
+        uint32_t eye_width{0};
+        uint32_t eye_height{0};
+        uint32_t ui_width{0};  // UEVR's UI render target, also the upper bound
+        uint32_t ui_height{0};
+        float oversample{1.0f};
+        float min_scale{0.25f};
+    };
+
+    struct Result {
+        float pixels_per_degree_x{0.0f};
+        float pixels_per_degree_y{0.0f};
+        float ui_degrees_x{0.0f};
+        float ui_degrees_y{0.0f};
+        float scale{1.0f}; // of the UI render target on both axes
+        uint32_t width{0};
+        uint32_t height{0};
+
+        bool operator==(const Result&) const = default;
+    };
+
+    static std::optional<Result> compute(const Input& in) {
+        if (in.placement.size <= 0.0f || in.placement.distance <= 0.0f || in.projection_x_scale <= 0.0f || in.projection_y_scale <= 0.0f ||
+            in.eye_width == 0 || in.eye_height == 0 || in.ui_width == 0 || in.ui_height == 0)
+        {
+            return std::nullopt;
+        }
+
+        constexpr float deg_per_rad = 180.0f / 3.14159265358979f;
+
+        Result out{};
+
+        // Center of the eye image, where a rectilinear projection has the fewest pixels per degree.
+        // Pixels per unit of tangent is half the image over half the tangent range.
+        out.pixels_per_degree_x = (float)in.eye_width * 0.5f * in.projection_x_scale / deg_per_rad;
+        out.pixels_per_degree_y = (float)in.eye_height * 0.5f * in.projection_y_scale / deg_per_rad;
+
+        const auto quad_height = in.placement.size * (float)in.ui_height / (float)in.ui_width;
+        out.ui_degrees_x = 2.0f * std::atan(in.placement.size * 0.5f / in.placement.distance) * deg_per_rad;
+        out.ui_degrees_y = 2.0f * std::atan(quad_height * 0.5f / in.placement.distance) * deg_per_rad;
+
+        const auto needed_x = out.ui_degrees_x * out.pixels_per_degree_x * in.oversample;
+        const auto needed_y = out.ui_degrees_y * out.pixels_per_degree_y * in.oversample;
+
+        // One scale for both axes so the UI layout keeps its aspect ratio
+        out.scale = std::clamp((std::max)(needed_x / (float)in.ui_width, needed_y / (float)in.ui_height), in.min_scale, 1.0f);
+        out.width = (std::min)(in.ui_width, ((uint32_t)std::ceil((float)in.ui_width * out.scale) + 1) & ~1u);
+        out.height = (std::min)(in.ui_height, ((uint32_t)std::ceil((float)in.ui_height * out.scale) + 1) & ~1u);
+
+        return out;
+    }
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "DirtyRects.hpp"
+#include "UIAlphaProbe.hpp"
+
+// The plugin's UI work on the present thread: clearing the engine's UI texture when the swap asks for it,
+// snapshots of UEVR's UI render target and alpha probes of whatever the UI is being drawn into.
+// With the probe on, a texture it has seen stay empty long enough doesn't get cleared at all, as long as the
+// probe has caught up with the last frame anything was drawn into it. Otherwise it's a full clear.
+// Only ever sees native resources and talks to the renderer through the per-frame Renderer<T> functions,
+// so the same sequence runs against Renderer<RendererType::Null> in the tests.
+class UIPresentWork {
+public:
+    struct Config {
+        bool snapshots{false};
+        bool probe{false};
+    };
+
+    // Native resources for this frame, nullptr where there's nothing to work on
+    struct Targets {
+        void* clear{nullptr}; // engine UI texture the swap wants cleared
+        void* ui{nullptr};    // UEVR's UI render target
+        void* draw{nullptr};  // whatever the engine draws the UI into right now
+    };
+
+    struct Result {
+        bool cleared{false};
+        bool clear_skipped{false}; // the probe saw nothing drawn into the texture
+        bool probe_stale{false};   // the texture was drawn into after the newest probe of it, fully cleared
+        bool empty_changed{false}; // the latest probe result flipped between empty and visible
+    };
+
+    void set_config(const Config& config) { m_config = config; }
+    const Config& get_config() const { return m_config; }
+
+    template <typename R>
+    Result run(R& renderer, const Targets& targets, uint32_t frame) {
+        Result result{};
+
+        if (m_config.probe) {
+            result.empty_changed = poll_probe(renderer);
+        }
+
+        // The UI for this frame is already in the draw target by the time we get to present
+        if (targets.draw != nullptr) {
+            record_draw(targets.draw, frame);
+        }
+
+        const auto trusted = targets.clear != nullptr && m_dirty.is_trusted(targets.clear);
+        const auto fresh = trusted && is_probe_fresh(targets.clear);
+        result.probe_stale = trusted && !fresh;
+
+        if (fresh && m_dirty.is_empty(targets.clear)) {
+            m_dirty.reset();
+            ++m_skipped_clears;
+            result.clear_skipped = true;
+        } else if (targets.clear != nullptr) {
+            const float clear_color[4]{0.0f, 0.0f, 0.0f, 1.0f}; // why is the alpha channel 1.0f? it works though
+            renderer.clear_ui(targets.clear, clear_color, frame, fresh ? &m_dirty : nullptr);
+            m_dirty.reset();
+            result.cleared = true;
+        }
+
+        if (m_config.snapshots && targets.ui != nullptr) {
+            renderer.snapshot_ui(targets.ui, frame);
+        }
+
+        // Probes whatever the engine is drawing the UI into, which also tells us where
+        // its own texture has content by the time the swap asks for it to be cleared
+        if (m_config.probe && targets.draw != nullptr) {
+            renderer.probe_ui(targets.draw, frame);
+        }
+
+        return result;
+    }
+
+    const UIEmptyStats& get_empty_stats() const { return m_empty_stats; }
+    const DirtyRects& get_dirty() const { return m_dirty; }
+    uint32_t get_skipped_clears() const { return m_skipped_clears; }
+
+private:
+    struct Draw {
+        const void* texture{nullptr};
+        uint64_t frame{0};
+    };
+
+    void record_draw(const void* texture, uint64_t frame) {
+        auto* slot = &m_draws[0];
+
+        for (auto& draw : m_draws) {
+            if (draw.texture == texture) {
+                slot = &draw;
+                break;
+            }
+
+            if (draw.frame < slot->frame) {
+                slot = &draw;
+            }
+        }
+
+        *slot = {texture, frame};
+    }
+
+    // Whether the probe has seen everything drawn into texture. A texture we lost track of counts as stale.
+    bool is_probe_fresh(const void* texture) const {
+        for (const auto& draw : m_draws) {
+            if (draw.texture == texture) {
+                return m_dirty.get_frame() >= draw.frame;
+            }
+        }
+
+        return false;
+    }
+
+    template <typename R>
+    bool poll_probe(R& renderer) {
+        const auto result = renderer.poll_ui_probe();
+
+        if (!result) {
+            return false;
+        }
+
+        m_dirty.add(result->texture, result->coverage, result->frame);
+        return m_empty_stats.record(*result);
+    }
+
+    Config m_config{};
+    UIEmptyStats m_empty_stats{};
+    DirtyRects m_dirty{}; // coverage of the draw target as seen by the probe
+    std::array<Draw, 4> m_draws{}; // last frame each of the recent draw targets was drawn into
+    uint32_t m_skipped_clears{0};
+};
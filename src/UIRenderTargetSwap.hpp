@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+
+// Swaps the engine's InGameUIRenderTarget texture for UEVR's UI render target and back.
+// Texture is only ever compared and passed around, never dereferenced,
+// so any pointer type works (API::FRHITexture2D in the plugin).
+//
+// Inactive: the pooled target holds an engine texture, or our texture without a saved engine
+//           texture to go back to (e.g. after the pooled target went missing for a while)
+// Swapped:  the pooled target holds UEVR's UI render target, the engine texture is saved so it
+//           can be restored once the HMD goes inactive or the UI render target disappears
+//
+// An engine texture handed to us again right after we cleared it isn't cleared twice. Anything else is
+// cleared, including a pooled texture that went to some other target in between and came back with
+// that target's contents. Restoring forgets the last clear, the engine draws into its own texture again.
+template <typename Texture>
+class UIRenderTargetSwap {
+public:
+    enum class State : uint8_t {
+        Inactive,
+        Swapped,
+    };
+
+    struct Result {
+        Texture* texture{nullptr}; // what the pooled render target should point at now
+        Texture* clear{nullptr};   // engine texture that needs clearing, if any
+    };
+
+    struct Stats {
+        uint32_t swaps{0};          // Inactive -> Swapped
+        uint32_t restores{0};       // Swapped -> Inactive with the engine texture put back
+        uint32_t reallocations{0};  // engine handed out a new texture while Swapped
+        uint32_t retargets{0};      // UEVR reallocated its UI render target
+        uint32_t clears{0};
+        uint32_t clears_skipped{0}; // same texture as the last one cleared
+    };
+
+    // Called every Slate draw with the pooled target's current texture
+    Result update(Texture* current, Texture* current_srt, Texture* ui_target, bool hmd_active) {
+        if (m_state == State::Swapped) {
+            return update_swapped(current, current_srt, ui_target, hmd_active);
+        }
+
+        return update_inactive(current, current_srt, ui_target, hmd_active);
+    }
+
+    // The pool doesn't have the render target right now, nothing to restore into
+    void on_target_missing() {
+        to_inactive();
+    }
+
+    State get_state() const { return m_state; }
+    Texture* get_engine_texture() const { return m_engine_tex; }
+    Texture* get_engine_srt() const { return m_engine_srt; }
+    const Stats& get_stats() const { return m_stats; }
+
+private:
+    Result update_inactive(Texture* current, Texture* current_srt, Texture* ui_target, bool hmd_active) {
+        if (current == nullptr || !hmd_active || ui_target == nullptr) {
+            m_ui_tex = nullptr;
+            return {current, nullptr};
+        }
+
+        // Already ours, we just lost track of the engine texture at some point
+        if (current == ui_target) {
+            m_ui_tex = ui_target;
+            return {current, nullptr};
+        }
+
+        if (current == m_ui_tex) {
+            ++m_stats.retargets;
+            m_ui_tex = ui_target;
+            return {ui_target, nullptr};
+        }
+
+        ++m_stats.swaps;
+        m_state = State::Swapped;
+
+        return swap_in(current, current_srt, ui_target);
+    }
+
+    Result update_swapped(Texture* current, Texture* current_srt, Texture* ui_target, bool hmd_active) {
+        if (current == nullptr) {
+            to_inactive();
+            m_ui_tex = nullptr;
+            return {current, nullptr};
+        }
+
+        if (!hmd_active || ui_target == nullptr) {
+            Result result{current, nullptr};
+
+            if (current == m_ui_tex || (ui_target != nullptr && current == ui_target)) {
+                result.texture = m_engine_tex;
+                ++m_stats.restores;
+            }
+
+            to_inactive();
+            m_ui_tex = nullptr;
+            return result;
+        }
+
+        if (current == ui_target) {
+            m_ui_tex = ui_target;
+            return {current, nullptr};
+        }
+
+        if (current == m_ui_tex) {
+            ++m_stats.retargets;
+            m_ui_tex = ui_target;
+            return {ui_target, nullptr};
+        }
+
+        ++m_stats.reallocations;
+        return swap_in(current, current_srt, ui_target);
+    }
+
+    Result swap_in(Texture* engine_tex, Texture* engine_srt, Texture* ui_target) {
+        m_engine_tex = engine_tex;
+        m_engine_srt = engine_srt;
+        m_ui_tex = ui_target;
+
+        return {ui_target, should_clear(engine_tex) ? engine_tex : nullptr};
+    }
+
+    bool should_clear(Texture* tex) {
+        // Nothing but us could have drawn into it since the last clear
+        if (tex == m_last_cleared) {
+            ++m_stats.clears_skipped;
+            return false;
+        }
+
+        m_last_cleared = tex;
+        ++m_stats.clears;
+        return true;
+    }
+
+    void to_inactive() {
+        m_state = State::Inactive;
+        m_engine_tex = nullptr;
+        m_engine_srt = nullptr;
+        m_last_cleared = nullptr;
+    }
+
+    State m_state{State::Inactive};
+    Texture* m_engine_tex{nullptr}; // The engine's render target
+    Texture* m_engine_srt{nullptr}; // The engine's render target
+    Texture* m_ui_tex{nullptr}; // Our render target we made
+
+    Texture* m_last_cleared{nullptr};
+
+    Stats m_stats{};
+};
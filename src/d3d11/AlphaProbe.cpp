@@ -0,0 +1,164 @@
+#include <spdlog/spdlog.h>
+
+#include "AlphaProbe.hpp"
+
+namespace d3d11 {
+bool AlphaProbe::setup(ID3D11Device* device) {
+    reset();
+
+    const auto bytecode = get_ui_alpha_probe_bytecode();
+
+    if (device == nullptr || bytecode == nullptr) {
+        return false;
+    }
+
+    if (FAILED(device->CreateComputeShader(bytecode->GetBufferPointer(), bytecode->GetBufferSize(), nullptr, &shader))) {
+        spdlog::error("[AlphaProbe] Failed to create compute shader");
+        reset();
+        return false;
+    }
+
+    D3D11_BUFFER_DESC cb_desc{};
+    cb_desc.ByteWidth = 16;
+    cb_desc.Usage = D3D11_USAGE_DEFAULT;
+    cb_desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+
+    if (FAILED(device->CreateBuffer(&cb_desc, nullptr, &constants))) {
+        spdlog::error("[AlphaProbe] Failed to create constant buffer");
+        reset();
+        return false;
+    }
+
+    D3D11_TEXTURE2D_DESC result_desc{};
+    result_desc.Width = 2;
+    result_desc.Height = 1;
+    result_desc.MipLevels = 1;
+    result_desc.ArraySize = 1;
+    result_desc.Format = DXGI_FORMAT_R32_UINT;
+    result_desc.SampleDesc.Count = 1;
+    result_desc.Usage = D3D11_USAGE_DEFAULT;
+    result_desc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+
+    if (FAILED(device->CreateTexture2D(&result_desc, nullptr, &result)) ||
+        FAILED(device->CreateUnorderedAccessView(result.Get(), nullptr, &result_uav)))
+    {
+        spdlog::error("[AlphaProbe] Failed to create result texture");
+        reset();
+        return false;
+    }
+
+    device->GetImmediateContext(&context);
+    return true;
+}
+
+void AlphaProbe::reset() {
+    readback.reset();
+    srv.Reset();
+    srv_texture = nullptr;
+    sources.fill(nullptr);
+    result_uav.Reset();
+    result.Reset();
+    constants.Reset();
+    shader.Reset();
+    context.Reset();
+    last_frame = 0;
+}
+
+bool AlphaProbe::update_srv(ID3D11Device* device, ID3D11Texture2D* src) {
+    // Also remembers failures so a texture without SRV support doesn't log every frame
+    if (srv_texture == src) {
+        return srv != nullptr;
+    }
+
+    srv.Reset();
+    srv_texture = src;
+
+    D3D11_TEXTURE2D_DESC src_desc{};
+    src->GetDesc(&src_desc);
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srv_desc{};
+    srv_desc.Format = get_ui_alpha_probe_srv_format(src_desc.Format);
+    srv_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srv_desc.Texture2D.MostDetailedMip = 0;
+    srv_desc.Texture2D.MipLevels = 1;
+
+    if (FAILED(device->CreateShaderResourceView(src, &srv_desc, &srv))) {
+        spdlog::error("[AlphaProbe] Failed to create SRV for format {}", (uint32_t)src_desc.Format);
+        return false;
+    }
+
+    return true;
+}
+
+bool AlphaProbe::queue(ID3D11Device* device, ID3D11Texture2D* src, uint32_t frame) {
+    if (device == nullptr || src == nullptr) {
+        return false;
+    }
+
+    if (!is_setup() && !setup(device)) {
+        return false;
+    }
+
+    if (!update_srv(device, src)) {
+        return false;
+    }
+
+    D3D11_TEXTURE2D_DESC src_desc{};
+    src->GetDesc(&src_desc);
+
+    // Whatever the game or UEVR had bound, put back after the dispatch
+    ComPtr<ID3D11ComputeShader> prev_shader{};
+    ComPtr<ID3D11ShaderResourceView> prev_srv{};
+    ComPtr<ID3D11UnorderedAccessView> prev_uav{};
+    ComPtr<ID3D11Buffer> prev_cb{};
+    context->CSGetShader(&prev_shader, nullptr, nullptr);
+    context->CSGetShaderResources(0, 1, &prev_srv);
+    context->CSGetUnorderedAccessViews(0, 1, &prev_uav);
+    context->CSGetConstantBuffers(0, 1, &prev_cb);
+
+    const uint32_t params[4]{get_ui_alpha_probe_groups(src_desc.Width), get_ui_alpha_probe_groups(src_desc.Height), 0, 0};
+    context->UpdateSubresource(constants.Get(), 0, nullptr, params, 0, 0);
+
+    const UINT zero[4]{};
+    context->ClearUnorderedAccessViewUint(result_uav.Get(), zero);
+
+    context->CSSetShader(shader.Get(), nullptr, 0);
+    context->CSSetShaderResources(0, 1, srv.GetAddressOf());
+    context->CSSetUnorderedAccessViews(0, 1, result_uav.GetAddressOf(), nullptr);
+    context->CSSetConstantBuffers(0, 1, constants.GetAddressOf());
+    context->Dispatch(params[0], params[1], 1);
+
+    context->CSSetShader(prev_shader.Get(), nullptr, 0);
+    context->CSSetShaderResources(0, 1, prev_srv.GetAddressOf());
+    context->CSSetUnorderedAccessViews(0, 1, prev_uav.GetAddressOf(), nullptr);
+    context->CSSetConstantBuffers(0, 1, prev_cb.GetAddressOf());
+
+    if (!readback.queue_copy(device, result.Get(), frame)) {
+        return false;
+    }
+
+    sources[frame % ReadbackRing::NUM_SLOTS] = src;
+    return true;
+}
+
+std::optional<UIAlphaResult> AlphaProbe::poll() {
+    const auto view = readback.map_latest();
+
+    if (!view || view->frame <= last_frame) {
+        return std::nullopt;
+    }
+
+    last_frame = view->frame;
+
+    const auto words = view->row_as<uint32_t>(0);
+
+    UIAlphaResult out{};
+    out.frame = view->frame;
+    out.texture = sources[view->frame % ReadbackRing::NUM_SLOTS];
+    out.coverage = (uint64_t)words[0] | ((uint64_t)words[1] << 32);
+    out.empty = out.coverage == 0;
+
+    readback.unmap();
+    return out;
+}
+}
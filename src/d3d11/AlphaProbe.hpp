@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <d3d11.h>
+
+#include "../UIAlphaProbe.hpp"
+#include "ComPtr.hpp"
+#include "ReadbackRing.hpp"
+
+namespace d3d11 {
+// Finds which parts of a texture have any non-zero alpha with one small dispatch,
+// the answer comes back through a ReadbackRing a few frames later.
+// The immediate context's compute bindings are put back the way they were after the dispatch.
+struct AlphaProbe {
+    bool setup(ID3D11Device* device);
+    void reset();
+    bool is_setup() const { return shader != nullptr; }
+
+    bool queue(ID3D11Device* device, ID3D11Texture2D* src, uint32_t frame);
+
+    // Newest result that hasn't been returned yet
+    std::optional<UIAlphaResult> poll();
+
+    virtual ~AlphaProbe() { reset(); }
+
+private:
+    bool update_srv(ID3D11Device* device, ID3D11Texture2D* src);
+
+    ComPtr<ID3D11DeviceContext> context{};
+    ComPtr<ID3D11ComputeShader> shader{};
+    ComPtr<ID3D11Buffer> constants{};
+    ComPtr<ID3D11Texture2D> result{};
+    ComPtr<ID3D11UnorderedAccessView> result_uav{};
+    ComPtr<ID3D11ShaderResourceView> srv{};
+    ID3D11Texture2D* srv_texture{nullptr}; // only compared, never dereferenced
+    ReadbackRing readback{};
+    std::array<const void*, ReadbackRing::NUM_SLOTS> sources{};
+    uint64_t last_frame{0};
+};
+}
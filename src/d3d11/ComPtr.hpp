@@ -0,0 +1,7 @@
+#pragma once
+
+#include <wrl.h>
+
+namespace d3d11 {
+template <typename T> using ComPtr = Microsoft::WRL::ComPtr<T>;
+}
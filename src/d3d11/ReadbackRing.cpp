@@ -0,0 +1,171 @@
+#include <spdlog/spdlog.h>
+
+#include "ReadbackRing.hpp"
+
+namespace d3d11 {
+bool ReadbackRing::setup_slot(ID3D11Device* device, Slot& slot, const D3D11_TEXTURE2D_DESC& src_desc) {
+    slot.staging.Reset();
+    slot.query.Reset();
+
+    slot.desc = src_desc;
+    slot.desc.MipLevels = 1;
+    slot.desc.ArraySize = 1;
+    slot.desc.SampleDesc.Count = 1;
+    slot.desc.SampleDesc.Quality = 0;
+    slot.desc.Usage = D3D11_USAGE_STAGING;
+    slot.desc.BindFlags = 0;
+    slot.desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    slot.desc.MiscFlags = 0;
+
+    if (FAILED(device->CreateTexture2D(&slot.desc, nullptr, &slot.staging))) {
+        spdlog::error("[ReadbackRing] Failed to create staging texture");
+        return false;
+    }
+
+    D3D11_QUERY_DESC query_desc{};
+    query_desc.Query = D3D11_QUERY_EVENT;
+
+    if (FAILED(device->CreateQuery(&query_desc, &slot.query))) {
+        spdlog::error("[ReadbackRing] Failed to create event query");
+        slot.staging.Reset();
+        return false;
+    }
+
+    return true;
+}
+
+bool ReadbackRing::poll(Slot& slot) {
+    if (!slot.pending) {
+        return slot.done;
+    }
+
+    BOOL result{FALSE};
+    if (context->GetData(slot.query.Get(), &result, sizeof(result), D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK && result) {
+        slot.pending = false;
+        slot.done = true;
+        ++completed;
+    }
+
+    return slot.done;
+}
+
+bool ReadbackRing::queue_copy(ID3D11Device* device, ID3D11Texture2D* src, uint64_t frame) {
+    if (device == nullptr || src == nullptr) {
+        return false;
+    }
+
+    if (context == nullptr) {
+        device->GetImmediateContext(&context);
+    }
+
+    const auto index = frame % NUM_SLOTS;
+    auto& slot = slots[index];
+
+    if (slot.pending && !poll(slot)) {
+        ++skipped;
+        return false;
+    }
+
+    // CopyResource into a mapped staging texture is not allowed
+    if (mapped == index) {
+        unmap();
+    }
+
+    if (latest == index) {
+        latest.reset();
+    }
+
+    D3D11_TEXTURE2D_DESC src_desc{};
+    src->GetDesc(&src_desc);
+
+    if (slot.staging == nullptr || slot.desc.Width != src_desc.Width || 
+        slot.desc.Height != src_desc.Height || slot.desc.Format != src_desc.Format) 
+    {
+        if (!setup_slot(device, slot, src_desc)) {
+            return false;
+        }
+    }
+
+    if (src_desc.MipLevels == 1 && src_desc.ArraySize == 1 && src_desc.SampleDesc.Count == 1) {
+        context->CopyResource(slot.staging.Get(), src);
+    } else {
+        context->CopySubresourceRegion(slot.staging.Get(), 0, 0, 0, 0, src, 0, nullptr);
+    }
+
+    context->End(slot.query.Get());
+
+    slot.frame = frame;
+    slot.pending = true;
+    slot.done = false;
+
+    return true;
+}
+
+std::optional<ReadbackView> ReadbackRing::map_latest() {
+    if (context == nullptr) {
+        return std::nullopt;
+    }
+
+    for (size_t i = 0; i < NUM_SLOTS; ++i) {
+        auto& slot = slots[i];
+
+        if (slot.pending && poll(slot)) {
+            if (!latest || slots[*latest].frame < slot.frame) {
+                latest = i;
+            }
+        }
+    }
+
+    if (!latest) {
+        return std::nullopt;
+    }
+
+    if (mapped == latest) {
+        return mapped_view;
+    }
+
+    unmap();
+
+    auto& slot = slots[*latest];
+
+    D3D11_MAPPED_SUBRESOURCE mapped_resource{};
+
+    // The copy is known to be done, DO_NOT_WAIT is just a safety net against a stall
+    if (FAILED(context->Map(slot.staging.Get(), 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped_resource))) {
+        return std::nullopt;
+    }
+
+    mapped = latest;
+
+    mapped_view.data = (const uint8_t*)mapped_resource.pData;
+    mapped_view.width = slot.desc.Width;
+    mapped_view.height = slot.desc.Height;
+    mapped_view.row_pitch = mapped_resource.RowPitch;
+    mapped_view.format = slot.desc.Format;
+    mapped_view.frame = slot.frame;
+
+    return mapped_view;
+}
+
+void ReadbackRing::unmap() {
+    if (mapped && context != nullptr) {
+        context->Unmap(slots[*mapped].staging.Get(), 0);
+    }
+
+    mapped.reset();
+}
+
+void ReadbackRing::reset() {
+    unmap();
+
+    for (auto& slot : slots) {
+        slot.staging.Reset();
+        slot.query.Reset();
+        slot.pending = false;
+        slot.done = false;
+    }
+
+    context.Reset();
+    latest.reset();
+}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <d3d11.h>
+
+#include "../Readback.hpp"
+#include "ComPtr.hpp"
+
+namespace d3d11 {
+// D3D11 counterpart of d3d12::ReadbackRing.
+// Completion is tracked with an event query per slot and polled with DONOTFLUSH
+// so nothing here can stall the immediate context.
+struct ReadbackRing {
+    static constexpr size_t NUM_SLOTS = 3;
+
+    struct Slot {
+        ComPtr<ID3D11Texture2D> staging{};
+        ComPtr<ID3D11Query> query{};
+        D3D11_TEXTURE2D_DESC desc{};
+        uint64_t frame{0};
+        bool pending{false};
+        bool done{false};
+    };
+
+    bool queue_copy(ID3D11Device* device, ID3D11Texture2D* src, uint64_t frame);
+
+    // Newest snapshot whose copy has completed, if any.
+    // The view stays valid until unmap() or the next call to map_latest/queue_copy.
+    std::optional<ReadbackView> map_latest();
+    void unmap();
+    void reset();
+
+    virtual ~ReadbackRing() { reset(); }
+
+    uint32_t num_skipped() const { return skipped; }
+    uint32_t num_completed() const { return completed; }
+
+private:
+    bool setup_slot(ID3D11Device* device, Slot& slot, const D3D11_TEXTURE2D_DESC& src_desc);
+    bool poll(Slot& slot);
+
+    std::array<Slot, NUM_SLOTS> slots{};
+    ComPtr<ID3D11DeviceContext> context{};
+    std::optional<size_t> latest{};
+    std::optional<size_t> mapped{};
+    ReadbackView mapped_view{};
+    uint32_t skipped{0};
+    uint32_t completed{0};
+};
+}
@@ -0,0 +1,91 @@
+#include <spdlog/spdlog.h>
+
+#include "TimestampQueries.hpp"
+
+namespace d3d11 {
+bool TimestampQueries::setup(ID3D11Device* device) {
+    reset();
+
+    if (device == nullptr) {
+        return false;
+    }
+
+    D3D11_QUERY_DESC disjoint_desc{};
+    disjoint_desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+
+    D3D11_QUERY_DESC timestamp_desc{};
+    timestamp_desc.Query = D3D11_QUERY_TIMESTAMP;
+
+    for (auto& slot : slots) {
+        if (FAILED(device->CreateQuery(&disjoint_desc, &slot.disjoint))) {
+            spdlog::error("[TimestampQueries] Failed to create disjoint query");
+            reset();
+            return false;
+        }
+
+        for (auto& ts : slot.timestamps) {
+            if (FAILED(device->CreateQuery(&timestamp_desc, &ts))) {
+                spdlog::error("[TimestampQueries] Failed to create timestamp query");
+                reset();
+                return false;
+            }
+        }
+    }
+
+    device->GetImmediateContext(&context);
+    return true;
+}
+
+void TimestampQueries::reset() {
+    for (auto& slot : slots) {
+        slot.disjoint.Reset();
+
+        for (auto& ts : slot.timestamps) {
+            ts.Reset();
+        }
+    }
+
+    context.Reset();
+}
+
+bool TimestampQueries::begin_frame(uint32_t slot) {
+    if (context == nullptr) {
+        return false;
+    }
+
+    context->Begin(slots[slot].disjoint.Get());
+    return true;
+}
+
+void TimestampQueries::timestamp(uint32_t slot, uint32_t index, Context ctx) {
+    ctx->End(slots[slot].timestamps[index].Get());
+}
+
+bool TimestampQueries::end_frame(uint32_t slot, uint32_t) {
+    context->End(slots[slot].disjoint.Get());
+    return true;
+}
+
+bool TimestampQueries::read(uint32_t slot, uint32_t count, uint64_t* out, uint64_t& frequency) {
+    if (context == nullptr) {
+        return false;
+    }
+
+    auto& s = slots[slot];
+
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint{};
+    if (context->GetData(s.disjoint.Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (context->GetData(s.timestamps[i].Get(), &out[i], sizeof(uint64_t), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+            return false;
+        }
+    }
+
+    // The clock changed somewhere in the frame, the slot is done but the values are garbage
+    frequency = disjoint.Disjoint ? 0 : disjoint.Frequency;
+    return true;
+}
+}
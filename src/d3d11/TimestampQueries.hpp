@@ -0,0 +1,32 @@
+#pragma once
+
+#include <array>
+#include <d3d11.h>
+
+#include "../GpuProfiler.hpp"
+#include "ComPtr.hpp"
+
+namespace d3d11 {
+// GpuProfiler query backend, one disjoint query per frame slot wrapping the timestamps
+struct TimestampQueries {
+    using Context = ID3D11DeviceContext*;
+
+    bool setup(ID3D11Device* device);
+    void reset();
+    bool is_setup() const { return context != nullptr; }
+
+    bool begin_frame(uint32_t slot);
+    void timestamp(uint32_t slot, uint32_t index, Context ctx);
+    bool end_frame(uint32_t slot, uint32_t count);
+    bool read(uint32_t slot, uint32_t count, uint64_t* out, uint64_t& frequency);
+
+private:
+    struct Slot {
+        ComPtr<ID3D11Query> disjoint{};
+        std::array<ComPtr<ID3D11Query>, GPU_PROFILER_MAX_TIMESTAMPS> timestamps{};
+    };
+
+    ComPtr<ID3D11DeviceContext> context{};
+    std::array<Slot, GPU_PROFILER_FRAMES> slots{};
+};
+}
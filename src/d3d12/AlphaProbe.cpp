@@ -0,0 +1,205 @@
+#include <spdlog/spdlog.h>
+
+#include "AlphaProbe.hpp"
+
+namespace d3d12 {
+bool AlphaProbe::setup(ID3D12Device* device) {
+    reset();
+
+    const auto bytecode = get_ui_alpha_probe_bytecode();
+
+    if (device == nullptr || bytecode == nullptr) {
+        return false;
+    }
+
+    // b0: tile counts as root constants, table: SRV t0 then UAV u0
+    D3D12_DESCRIPTOR_RANGE ranges[2]{};
+    ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    ranges[0].NumDescriptors = 1;
+    ranges[0].BaseShaderRegister = 0;
+    ranges[0].OffsetInDescriptorsFromTableStart = 0;
+    ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    ranges[1].NumDescriptors = 1;
+    ranges[1].BaseShaderRegister = 0;
+    ranges[1].OffsetInDescriptorsFromTableStart = 1;
+
+    D3D12_ROOT_PARAMETER params[2]{};
+    params[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    params[0].Constants.ShaderRegister = 0;
+    params[0].Constants.Num32BitValues = 2;
+    params[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    params[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    params[1].DescriptorTable.NumDescriptorRanges = 2;
+    params[1].DescriptorTable.pDescriptorRanges = ranges;
+    params[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    D3D12_ROOT_SIGNATURE_DESC rs_desc{};
+    rs_desc.NumParameters = 2;
+    rs_desc.pParameters = params;
+
+    ComPtr<ID3DBlob> rs_blob{};
+    ComPtr<ID3DBlob> rs_errors{};
+
+    if (FAILED(D3D12SerializeRootSignature(&rs_desc, D3D_ROOT_SIGNATURE_VERSION_1, &rs_blob, &rs_errors)) ||
+        FAILED(device->CreateRootSignature(0, rs_blob->GetBufferPointer(), rs_blob->GetBufferSize(), IID_PPV_ARGS(&root_signature))))
+    {
+        spdlog::error("[AlphaProbe] Failed to create root signature");
+        reset();
+        return false;
+    }
+
+    D3D12_COMPUTE_PIPELINE_STATE_DESC pso_desc{};
+    pso_desc.pRootSignature = root_signature.Get();
+    pso_desc.CS.pShaderBytecode = bytecode->GetBufferPointer();
+    pso_desc.CS.BytecodeLength = bytecode->GetBufferSize();
+
+    if (FAILED(device->CreateComputePipelineState(&pso_desc, IID_PPV_ARGS(&pso)))) {
+        spdlog::error("[AlphaProbe] Failed to create pipeline state");
+        reset();
+        return false;
+    }
+
+    D3D12_HEAP_PROPERTIES heap_props{};
+    heap_props.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+    D3D12_RESOURCE_DESC result_desc{};
+    result_desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    result_desc.Width = 2;
+    result_desc.Height = 1;
+    result_desc.DepthOrArraySize = 1;
+    result_desc.MipLevels = 1;
+    result_desc.Format = DXGI_FORMAT_R32_UINT;
+    result_desc.SampleDesc.Count = 1;
+    result_desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+    if (FAILED(device->CreateCommittedResource(&heap_props, D3D12_HEAP_FLAG_NONE, &result_desc,
+        D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&result))))
+    {
+        spdlog::error("[AlphaProbe] Failed to create result texture");
+        reset();
+        return false;
+    }
+
+    result->SetName(L"FF7Plugin AlphaProbe");
+
+    try {
+        heap = std::make_unique<DirectX::DescriptorHeap>(device,
+            D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+            D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE,
+            ReadbackRing::NUM_SLOTS * 2);
+        clear_heap = std::make_unique<DirectX::DescriptorHeap>(device,
+            D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+            D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
+            1);
+    } catch(...) {
+        spdlog::error("[AlphaProbe] Failed to create descriptor heap");
+        reset();
+        return false;
+    }
+
+    for (size_t i = 0; i < ReadbackRing::NUM_SLOTS; ++i) {
+        device->CreateUnorderedAccessView(result.Get(), nullptr, nullptr, heap->GetCpuHandle(i * 2 + 1));
+    }
+
+    device->CreateUnorderedAccessView(result.Get(), nullptr, nullptr, clear_heap->GetCpuHandle(0));
+
+    return true;
+}
+
+void AlphaProbe::reset() {
+    readback.reset();
+    sources.fill(nullptr);
+    clear_heap.reset();
+    heap.reset();
+    result.Reset();
+    pso.Reset();
+    root_signature.Reset();
+    last_frame = 0;
+}
+
+void AlphaProbe::retire(DeferredRelease& deferred) {
+    readback.retire(deferred);
+
+    if (heap != nullptr && heap->Heap() != nullptr) {
+        ComPtr<ID3D12DescriptorHeap> heap_ref{heap->Heap()};
+        deferred.release(heap_ref);
+    }
+
+    deferred.release(result);
+    deferred.release(pso);
+    deferred.release(root_signature);
+    sources.fill(nullptr);
+    clear_heap.reset(); // CPU-only, the GPU never references it
+    heap.reset();
+    last_frame = 0;
+}
+
+CommandContext* AlphaProbe::begin(ID3D12Device* device, uint32_t frame) {
+    if (!is_setup() && !setup(device)) {
+        return nullptr;
+    }
+
+    return readback.begin_copy(device, result.Get(), frame);
+}
+
+void AlphaProbe::record(CommandContext& commands, ID3D12Device* device, ID3D12Resource* src, uint32_t frame) {
+    const auto slot = frame % ReadbackRing::NUM_SLOTS;
+    const auto src_desc = src->GetDesc();
+
+    // The slot's previous list has completed by now (begin checked), so its SRV can be rewritten
+    D3D12_SHADER_RESOURCE_VIEW_DESC srv_desc{};
+    srv_desc.Format = get_ui_alpha_probe_srv_format(src_desc.Format);
+    srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    srv_desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    srv_desc.Texture2D.MipLevels = 1;
+    device->CreateShaderResourceView(src, &srv_desc, heap->GetCpuHandle(slot * 2));
+
+    auto cmd_list = commands.cmd_list.Get();
+
+    ID3D12DescriptorHeap* heaps[]{heap->Heap()};
+    cmd_list->SetDescriptorHeaps(1, heaps);
+    cmd_list->SetComputeRootSignature(root_signature.Get());
+    cmd_list->SetPipelineState(pso.Get());
+
+    const UINT zero[4]{};
+    cmd_list->ClearUnorderedAccessViewUint(heap->GetGpuHandle(slot * 2 + 1), clear_heap->GetCpuHandle(0), result.Get(), zero, 0, nullptr);
+
+    D3D12_RESOURCE_BARRIER uav_barrier{};
+    uav_barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+    uav_barrier.UAV.pResource = result.Get();
+    cmd_list->ResourceBarrier(1, &uav_barrier);
+
+    const uint32_t num_tiles[2]{get_ui_alpha_probe_groups((uint32_t)src_desc.Width), get_ui_alpha_probe_groups(src_desc.Height)};
+    cmd_list->SetComputeRoot32BitConstants(0, 2, num_tiles, 0);
+    cmd_list->SetComputeRootDescriptorTable(1, heap->GetGpuHandle(slot * 2));
+    cmd_list->Dispatch(num_tiles[0], num_tiles[1], 1);
+
+    // The transition into COPY_SOURCE orders the copy after the dispatch's UAV writes
+    readback.record_copy(result.Get(), frame, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    sources[slot] = src;
+}
+
+void AlphaProbe::submit(ID3D12CommandQueue* queue, uint32_t frame) {
+    readback.submit(queue, frame);
+}
+
+std::optional<UIAlphaResult> AlphaProbe::poll() {
+    const auto view = readback.map_latest();
+
+    if (!view || view->frame <= last_frame) {
+        return std::nullopt;
+    }
+
+    last_frame = view->frame;
+
+    const auto words = view->row_as<uint32_t>(0);
+
+    UIAlphaResult out{};
+    out.frame = view->frame;
+    out.texture = sources[view->frame % ReadbackRing::NUM_SLOTS];
+    out.coverage = (uint64_t)words[0] | ((uint64_t)words[1] << 32);
+    out.empty = out.coverage == 0;
+
+    return out;
+}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <d3d12.h>
+
+#include <DescriptorHeap.h>
+
+#include "../UIAlphaProbe.hpp"
+#include "CommandContext.hpp"
+#include "DeferredRelease.hpp"
+#include "ReadbackRing.hpp"
+
+namespace d3d12 {
+// Finds which parts of a texture have any non-zero alpha with one small dispatch,
+// the answer comes back through a ReadbackRing a few frames later.
+// The dispatch and the readback copy share the ring's command list for the frame,
+// and each ring slot has its own pair of descriptors so a slot in flight is never rewritten.
+struct AlphaProbe {
+    bool setup(ID3D12Device* device);
+    void reset();
+    void retire(DeferredRelease& deferred);
+    bool is_setup() const { return pso != nullptr; }
+
+    // Same split as ReadbackRing, begin returns nullptr if the slot for this frame is still in flight.
+    // src has to be in a state compute shaders can read from.
+    CommandContext* begin(ID3D12Device* device, uint32_t frame);
+    void record(CommandContext& commands, ID3D12Device* device, ID3D12Resource* src, uint32_t frame);
+    void submit(ID3D12CommandQueue* queue, uint32_t frame);
+
+    // Newest result that hasn't been returned yet
+    std::optional<UIAlphaResult> poll();
+
+    virtual ~AlphaProbe() { reset(); }
+
+private:
+    ComPtr<ID3D12RootSignature> root_signature{};
+    ComPtr<ID3D12PipelineState> pso{};
+    ComPtr<ID3D12Resource> result{};
+    std::unique_ptr<DirectX::DescriptorHeap> heap{};
+    std::unique_ptr<DirectX::DescriptorHeap> clear_heap{}; // ClearUnorderedAccessViewUint needs a CPU-only descriptor too
+    ReadbackRing readback{};
+    std::array<const void*, ReadbackRing::NUM_SLOTS> sources{};
+    uint64_t last_frame{0};
+};
+}
@@ -3,6 +3,7 @@
 
 #include "TextureContext.hpp"
 #include "CommandContext.hpp"
+#include "DeferredRelease.hpp"
 
 namespace d3d12 {
 bool CommandContext::setup(ID3D12Device* device, const wchar_t* name) {
@@ -54,6 +55,29 @@ void CommandContext::reset() {
     this->waiting_for_fence = false;
 }
 
+// Non-blocking alternative to reset(), the objects are handed to the deferred release queue
+// and only freed once the GPU is done with whatever was last executed on them
+void CommandContext::retire(DeferredRelease& deferred) {
+    std::scoped_lock _{this->mtx};
+
+    deferred.release(this->cmd_allocator);
+    deferred.release(this->cmd_list);
+
+    // The fence event can still be signaled by the GPU so it has to live as long as the fence
+    ComPtr<IUnknown> fence_unk{};
+    if (this->fence != nullptr) {
+        this->fence.As(&fence_unk);
+    }
+
+    deferred.release(std::move(fence_unk), this->fence_event);
+
+    this->fence.Reset();
+    this->fence_value = 0;
+    this->fence_event = 0;
+    this->waiting_for_fence = false;
+    this->has_commands = false;
+}
+
 void CommandContext::wait(uint32_t ms) {
     std::scoped_lock _{this->mtx};
 
@@ -72,6 +96,15 @@ void CommandContext::wait(uint32_t ms) {
     }
 }
 
+// Non-blocking check for whether the last execute() has finished on the GPU
+bool CommandContext::is_complete() const {
+    if (!this->waiting_for_fence || this->fence == nullptr) {
+        return true;
+    }
+
+    return this->fence->GetCompletedValue() >= this->fence_value;
+}
+
 void CommandContext::copy(ID3D12Resource* src, ID3D12Resource* dst, D3D12_RESOURCE_STATES src_state, D3D12_RESOURCE_STATES dst_state) {
     std::scoped_lock _{this->mtx};
 
@@ -180,7 +213,50 @@ void CommandContext::copy_region(ID3D12Resource* src, ID3D12Resource* dst, D3D12
     this->has_commands = true;
 }
 
-void CommandContext::clear_rtv(ID3D12Resource* dst, D3D12_CPU_DESCRIPTOR_HANDLE rtv, const float* color, D3D12_RESOURCE_STATES dst_state) {
+void CommandContext::copy_to_buffer(ID3D12Resource* src, ID3D12Resource* dst, const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& footprint, D3D12_RESOURCE_STATES src_state) {
+    std::scoped_lock _{this->mtx};
+
+    if (src == nullptr || dst == nullptr) {
+        spdlog::error("[VR] nullptr passed to copy_to_buffer");
+        return;
+    }
+
+    // Switch src into copy source.
+    // Buffers on a readback heap are always in COPY_DEST so dst needs no barrier.
+    D3D12_RESOURCE_BARRIER src_barrier{};
+    src_barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    src_barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+    src_barrier.Transition.pResource = src;
+    src_barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    src_barrier.Transition.StateBefore = src_state;
+    src_barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+
+    this->cmd_list->ResourceBarrier(1, &src_barrier);
+
+    D3D12_TEXTURE_COPY_LOCATION src_loc{};
+    src_loc.pResource = src;
+    src_loc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+    src_loc.SubresourceIndex = 0;
+
+    D3D12_TEXTURE_COPY_LOCATION dst_loc{};
+    dst_loc.pResource = dst;
+    dst_loc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+    dst_loc.PlacedFootprint = footprint;
+
+    this->cmd_list->CopyTextureRegion(&dst_loc, 0, 0, 0, &src_loc, nullptr);
+
+    // Switch back to the original state.
+    src_barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE;
+    src_barrier.Transition.StateAfter = src_state;
+
+    this->cmd_list->ResourceBarrier(1, &src_barrier);
+
+    this->has_commands = true;
+}
+
+void CommandContext::clear_rtv(ID3D12Resource* dst, D3D12_CPU_DESCRIPTOR_HANDLE rtv, const float* color, D3D12_RESOURCE_STATES dst_state,
+    UINT num_rects, const D3D12_RECT* rects) 
+{
     std::scoped_lock _{this->mtx};
 
     if (dst == nullptr) {
@@ -203,8 +279,8 @@ void CommandContext::clear_rtv(ID3D12Resource* dst, D3D12_CPU_DESCRIPTOR_HANDLE
         this->cmd_list->ResourceBarrier(1, barriers);
     }
 
-    // Clear the resource.
-    this->cmd_list->ClearRenderTargetView(rtv, color, 0, nullptr);
+    // Clear the resource, all of it if there are no rects.
+    this->cmd_list->ClearRenderTargetView(rtv, color, rects != nullptr ? num_rects : 0, rects);
 
     // Switch back to present.
     dst_barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
@@ -218,29 +294,32 @@ void CommandContext::clear_rtv(ID3D12Resource* dst, D3D12_CPU_DESCRIPTOR_HANDLE
     this->has_commands = true;
 }
 
-void CommandContext::clear_rtv(d3d12::TextureContext& tex, const float* color, D3D12_RESOURCE_STATES dst_state) {
+void CommandContext::clear_rtv(d3d12::TextureContext& tex, const float* color, D3D12_RESOURCE_STATES dst_state, UINT num_rects, const D3D12_RECT* rects) {
     if (tex.texture == nullptr || tex.rtv_heap == nullptr) {
         return;
     }
 
-    this->clear_rtv(tex.texture.Get(), tex.get_rtv(), color, dst_state);
+    this->clear_rtv(tex.texture.Get(), tex.get_rtv(), color, dst_state, num_rects, rects);
 }
 
-void CommandContext::execute(ID3D12CommandQueue* command_queue) {
+bool CommandContext::execute(ID3D12CommandQueue* command_queue) {
     std::scoped_lock _{this->mtx};
     
-    if (this->has_commands) {
-        if (FAILED(this->cmd_list->Close())) {
-            spdlog::error("[VR] Failed to close command list. ({})", utility::narrow(this->internal_name));
-            return;
-        }
-        
-        ID3D12CommandList* const cmd_lists[] = {this->cmd_list.Get()};
-        command_queue->ExecuteCommandLists(1, cmd_lists);
-        command_queue->Signal(this->fence.Get(), ++this->fence_value);
-        this->fence->SetEventOnCompletion(this->fence_value, this->fence_event);
-        this->waiting_for_fence = true;
-        this->has_commands = false;
+    if (!this->has_commands) {
+        return false;
     }
+
+    if (FAILED(this->cmd_list->Close())) {
+        spdlog::error("[VR] Failed to close command list. ({})", utility::narrow(this->internal_name));
+        return false;
+    }
+    
+    ID3D12CommandList* const cmd_lists[] = {this->cmd_list.Get()};
+    command_queue->ExecuteCommandLists(1, cmd_lists);
+    command_queue->Signal(this->fence.Get(), ++this->fence_value);
+    this->fence->SetEventOnCompletion(this->fence_value, this->fence_event);
+    this->waiting_for_fence = true;
+    this->has_commands = false;
+    return true;
 }
 }
\ No newline at end of file
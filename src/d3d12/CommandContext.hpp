@@ -7,6 +7,7 @@
 
 namespace d3d12 {
 struct TextureContext;
+struct DeferredRelease;
 
 struct CommandContext {
     CommandContext() = default;
@@ -14,17 +15,24 @@ struct CommandContext {
 
     bool setup(ID3D12Device* device, const wchar_t* name = L"CommandContext object");
     void reset();
+    void retire(DeferredRelease& deferred);
     void wait(uint32_t ms);
+    bool is_complete() const;
     void copy(ID3D12Resource* src, ID3D12Resource* dst, 
         D3D12_RESOURCE_STATES src_state = D3D12_RESOURCE_STATE_PRESENT,
         D3D12_RESOURCE_STATES dst_state = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
     void copy_region(ID3D12Resource* src, ID3D12Resource* dst, D3D12_BOX* src_box, 
         D3D12_RESOURCE_STATES src_state = D3D12_RESOURCE_STATE_PRESENT,
         D3D12_RESOURCE_STATES dst_state = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    void copy_to_buffer(ID3D12Resource* src, ID3D12Resource* dst, const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& footprint,
+        D3D12_RESOURCE_STATES src_state = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
     void clear_rtv(ID3D12Resource* dst, D3D12_CPU_DESCRIPTOR_HANDLE rtv, const float* color, 
-        D3D12_RESOURCE_STATES dst_state = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-    void clear_rtv(TextureContext& tex, const float* color, D3D12_RESOURCE_STATES dst_state = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-    void execute(ID3D12CommandQueue* queue);
+        D3D12_RESOURCE_STATES dst_state = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+        UINT num_rects = 0, const D3D12_RECT* rects = nullptr);
+    void clear_rtv(TextureContext& tex, const float* color, D3D12_RESOURCE_STATES dst_state = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+        UINT num_rects = 0, const D3D12_RECT* rects = nullptr);
+    // True if commands were submitted and the fence will signal once they're done
+    bool execute(ID3D12CommandQueue* queue);
 
     ComPtr<ID3D12CommandAllocator> cmd_allocator{};
     ComPtr<ID3D12GraphicsCommandList> cmd_list{};
@@ -0,0 +1,109 @@
+#include <spdlog/spdlog.h>
+
+#include "DeferredRelease.hpp"
+
+namespace d3d12 {
+void DeferredRelease::release(ComPtr<IUnknown> object, HANDLE event) {
+    std::scoped_lock _{this->mtx};
+
+    if (object == nullptr && event == nullptr) {
+        return;
+    }
+
+    // Tagged with the value the next signal() will write
+    this->entries.push_back(Entry{this->fence_value + 1, std::move(object), event});
+}
+
+void DeferredRelease::signal(ID3D12CommandQueue* queue) {
+    std::scoped_lock _{this->mtx};
+
+    if (queue == nullptr) {
+        return;
+    }
+
+    if (this->fence == nullptr) {
+        ComPtr<ID3D12Device> device{};
+
+        if (FAILED(queue->GetDevice(IID_PPV_ARGS(&device)))) {
+            return;
+        }
+
+        if (FAILED(device->CreateFence(this->fence_value, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&this->fence)))) {
+            spdlog::error("[DeferredRelease] Failed to create fence");
+            return;
+        }
+
+        this->fence->SetName(L"FF7Plugin DeferredRelease");
+    }
+
+    queue->Signal(this->fence.Get(), ++this->fence_value);
+}
+
+void DeferredRelease::collect() {
+    std::scoped_lock _{this->mtx};
+
+    if (this->entries.empty() || this->fence == nullptr) {
+        return;
+    }
+
+    const auto completed = this->fence->GetCompletedValue();
+
+    // Entries are pushed in fence order so we can stop at the first one that is still in flight
+    while (!this->entries.empty() && this->entries.front().fence_value <= completed) {
+        this->free_entry(this->entries.front());
+        this->entries.pop_front();
+    }
+}
+
+void DeferredRelease::flush(ID3D12CommandQueue* queue, uint32_t ms) {
+    std::scoped_lock _{this->mtx};
+
+    if (!this->entries.empty()) {
+        this->signal(queue);
+
+        if (this->fence != nullptr && this->fence->GetCompletedValue() < this->fence_value) {
+            if (this->fence_event == nullptr) {
+                this->fence_event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+            }
+
+            this->fence->SetEventOnCompletion(this->fence_value, this->fence_event);
+
+            if (WaitForSingleObject(this->fence_event, ms) != WAIT_OBJECT_0) {
+                spdlog::error("[DeferredRelease] Timed out waiting for the GPU, releasing {} objects anyway", this->entries.size());
+            }
+        }
+    }
+
+    for (auto& entry : this->entries) {
+        this->free_entry(entry);
+    }
+
+    this->entries.clear();
+}
+
+void DeferredRelease::reset() {
+    std::scoped_lock _{this->mtx};
+
+    for (auto& entry : this->entries) {
+        this->free_entry(entry);
+    }
+
+    this->entries.clear();
+    this->fence.Reset();
+    this->fence_value = 0;
+
+    if (this->fence_event != nullptr) {
+        CloseHandle(this->fence_event);
+        this->fence_event = nullptr;
+    }
+}
+
+void DeferredRelease::free_entry(Entry& entry) {
+    entry.object.Reset();
+
+    if (entry.event != nullptr) {
+        CloseHandle(entry.event);
+        entry.event = nullptr;
+    }
+}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <d3d12.h>
+
+#include "ComPtr.hpp"
+
+namespace d3d12 {
+// Keeps released D3D12 objects alive until the GPU has passed the fence value
+// they were released at. signal() should be called once per present after all of
+// the plugin's work has been submitted, and collect() frees whatever has retired
+// without ever waiting on the GPU.
+struct DeferredRelease {
+    struct Entry {
+        uint64_t fence_value{};
+        ComPtr<IUnknown> object{};
+        HANDLE event{}; // closed alongside the object, for fence events that might still get signaled
+    };
+
+    void release(ComPtr<IUnknown> object, HANDLE event = nullptr);
+
+    template <typename T>
+    void release(ComPtr<T>& object) {
+        if (object != nullptr) {
+            ComPtr<IUnknown> unk{};
+            object.As(&unk);
+            release(std::move(unk));
+            object.Reset();
+        }
+    }
+
+    void signal(ID3D12CommandQueue* queue);
+    void collect();
+
+    // Blocks for up to ms waiting on the last signal, then frees everything regardless.
+    // Only for device resets and shutdown, never for the present path.
+    void flush(ID3D12CommandQueue* queue, uint32_t ms);
+    void reset();
+
+    size_t num_pending() const {
+        std::scoped_lock _{this->mtx};
+        return this->entries.size();
+    }
+
+    virtual ~DeferredRelease() { this->reset(); }
+
+private:
+    void free_entry(Entry& entry);
+
+    ComPtr<ID3D12Fence> fence{};
+    uint64_t fence_value{0};
+    HANDLE fence_event{};
+
+    std::deque<Entry> entries{};
+    mutable std::recursive_mutex mtx{};
+};
+}
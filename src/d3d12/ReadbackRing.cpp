@@ -0,0 +1,183 @@
+#include <spdlog/spdlog.h>
+
+#include "ReadbackRing.hpp"
+
+namespace d3d12 {
+bool ReadbackRing::setup_slot(ID3D12Device* device, Slot& slot, const D3D12_RESOURCE_DESC& desc) {
+    slot.buffer.Reset();
+    slot.mapped = nullptr;
+
+    UINT64 total_bytes{};
+    UINT num_rows{};
+    device->GetCopyableFootprints(&desc, 0, 1, 0, &slot.footprint, &num_rows, nullptr, &total_bytes);
+    slot.height = num_rows;
+
+    D3D12_HEAP_PROPERTIES heap_props{};
+    heap_props.Type = D3D12_HEAP_TYPE_READBACK;
+
+    D3D12_RESOURCE_DESC buffer_desc{};
+    buffer_desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    buffer_desc.Width = total_bytes;
+    buffer_desc.Height = 1;
+    buffer_desc.DepthOrArraySize = 1;
+    buffer_desc.MipLevels = 1;
+    buffer_desc.SampleDesc.Count = 1;
+    buffer_desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+    if (FAILED(device->CreateCommittedResource(&heap_props, D3D12_HEAP_FLAG_NONE, &buffer_desc, 
+        D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&slot.buffer)))) 
+    {
+        spdlog::error("[ReadbackRing] Failed to create readback buffer");
+        return false;
+    }
+
+    slot.buffer->SetName(L"FF7Plugin Readback");
+
+    // Readback heaps can stay persistently mapped, we only ever read from slots whose fence has passed
+    if (FAILED(slot.buffer->Map(0, nullptr, (void**)&slot.mapped))) {
+        spdlog::error("[ReadbackRing] Failed to map readback buffer");
+        slot.buffer.Reset();
+        return false;
+    }
+
+    if (slot.commands.cmd_list == nullptr) {
+        slot.commands.setup(device, L"FF7Plugin Readback");
+    }
+
+    return true;
+}
+
+bool ReadbackRing::queue_copy(ID3D12Device* device, ID3D12CommandQueue* queue, ID3D12Resource* src, uint64_t frame, D3D12_RESOURCE_STATES src_state) {
+    if (queue == nullptr || begin_copy(device, src, frame) == nullptr) {
+        return false;
+    }
+
+    record_copy(src, frame, src_state);
+    submit(queue, frame);
+
+    return true;
+}
+
+CommandContext* ReadbackRing::begin_copy(ID3D12Device* device, ID3D12Resource* src, uint64_t frame) {
+    if (device == nullptr || src == nullptr) {
+        return nullptr;
+    }
+
+    auto& slot = slots[frame % NUM_SLOTS];
+
+    if (slot.pending) {
+        if (!slot.commands.is_complete()) {
+            ++skipped;
+            return nullptr;
+        }
+
+        slot.pending = false;
+    }
+
+    // The fence has passed so this will not block, it just resets the allocator and list
+    slot.commands.wait(0);
+
+    if (latest && &slots[*latest] == &slot) {
+        latest.reset();
+    }
+
+    const auto desc = src->GetDesc();
+
+    if (slot.buffer == nullptr || slot.footprint.Footprint.Width != desc.Width || 
+        slot.footprint.Footprint.Height != desc.Height || slot.footprint.Footprint.Format != desc.Format) 
+    {
+        if (!setup_slot(device, slot, desc)) {
+            return nullptr;
+        }
+    }
+
+    return &slot.commands;
+}
+
+void ReadbackRing::record_copy(ID3D12Resource* src, uint64_t frame, D3D12_RESOURCE_STATES src_state) {
+    auto& slot = slots[frame % NUM_SLOTS];
+    slot.commands.copy_to_buffer(src, slot.buffer.Get(), slot.footprint, src_state);
+}
+
+void ReadbackRing::submit(ID3D12CommandQueue* queue, uint64_t frame) {
+    auto& slot = slots[frame % NUM_SLOTS];
+
+    // Nothing was recorded or the list didn't close, the buffer still holds whatever it had before
+    // and must not be reported as this frame's copy
+    if (!slot.commands.execute(queue)) {
+        ++skipped;
+        return;
+    }
+
+    slot.frame = frame;
+    slot.pending = true;
+}
+
+std::optional<ReadbackView> ReadbackRing::map_latest() {
+    // Promote any slots that finished since the last call
+    for (size_t i = 0; i < NUM_SLOTS; ++i) {
+        auto& slot = slots[i];
+
+        if (!slot.pending || !slot.commands.is_complete()) {
+            continue;
+        }
+
+        slot.pending = false;
+        ++completed;
+
+        if (!latest || slots[*latest].frame < slot.frame) {
+            latest = i;
+        }
+    }
+
+    if (!latest) {
+        return std::nullopt;
+    }
+
+    const auto& slot = slots[*latest];
+
+    if (slot.mapped == nullptr) {
+        return std::nullopt;
+    }
+
+    ReadbackView view{};
+    view.data = slot.mapped + slot.footprint.Offset;
+    view.width = slot.footprint.Footprint.Width;
+    view.height = slot.height;
+    view.row_pitch = slot.footprint.Footprint.RowPitch;
+    view.format = slot.footprint.Footprint.Format;
+    view.frame = slot.frame;
+
+    return view;
+}
+
+void ReadbackRing::reset() {
+    for (auto& slot : slots) {
+        if (slot.buffer != nullptr && slot.mapped != nullptr) {
+            slot.buffer->Unmap(0, nullptr);
+        }
+
+        slot.commands.reset();
+        slot.buffer.Reset();
+        slot.mapped = nullptr;
+        slot.pending = false;
+    }
+
+    latest.reset();
+}
+
+void ReadbackRing::retire(DeferredRelease& deferred) {
+    for (auto& slot : slots) {
+        if (slot.buffer != nullptr && slot.mapped != nullptr) {
+            slot.buffer->Unmap(0, nullptr);
+        }
+
+        slot.commands.retire(deferred);
+        deferred.release(slot.buffer);
+        slot.mapped = nullptr;
+        slot.pending = false;
+    }
+
+    latest.reset();
+}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <d3d12.h>
+
+#include "../Readback.hpp"
+#include "CommandContext.hpp"
+#include "DeferredRelease.hpp"
+
+namespace d3d12 {
+// Ring of readback buffers that never stalls the calling thread.
+// A copy queued in frame F becomes visible through map_latest() once its fence has passed,
+// which is usually around frame F + NUM_SLOTS. If the slot for the current frame is still in flight
+// the copy is simply skipped.
+struct ReadbackRing {
+    static constexpr size_t NUM_SLOTS = 3;
+
+    struct Slot {
+        CommandContext commands{};
+        ComPtr<ID3D12Resource> buffer{};
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint{};
+        uint32_t height{0};
+        uint8_t* mapped{nullptr};
+        uint64_t frame{0};
+        bool pending{false};
+    };
+
+    bool queue_copy(ID3D12Device* device, ID3D12CommandQueue* queue, ID3D12Resource* src, uint64_t frame,
+                    D3D12_RESOURCE_STATES src_state = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+    // queue_copy split into its steps, for callers that need to record extra work around the copy.
+    // begin_copy returns nullptr if the slot for this frame is still in flight, in which case
+    // record_copy and submit must not be called.
+    CommandContext* begin_copy(ID3D12Device* device, ID3D12Resource* src, uint64_t frame);
+    void record_copy(ID3D12Resource* src, uint64_t frame, D3D12_RESOURCE_STATES src_state = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    void submit(ID3D12CommandQueue* queue, uint64_t frame);
+
+    // Newest snapshot whose fence has passed, if any.
+    std::optional<ReadbackView> map_latest();
+    void reset();
+    void retire(DeferredRelease& deferred);
+
+    virtual ~ReadbackRing() { reset(); }
+
+    uint32_t num_skipped() const { return skipped; }
+    uint32_t num_completed() const { return completed; }
+
+private:
+    bool setup_slot(ID3D12Device* device, Slot& slot, const D3D12_RESOURCE_DESC& desc);
+
+    std::array<Slot, NUM_SLOTS> slots{};
+    std::optional<size_t> latest{};
+    uint32_t skipped{0};
+    uint32_t completed{0};
+};
+}
@@ -5,6 +5,7 @@
 #include <DescriptorHeap.h>
 
 #include "CommandContext.hpp"
+#include "DeferredRelease.hpp"
 
 namespace d3d12 {
 struct TextureContext {
@@ -36,6 +37,22 @@ struct TextureContext {
         texture.Reset();
     }
 
+    // Same as reset() but without waiting on the GPU
+    void retire(DeferredRelease& deferred) {
+        commands.retire(deferred);
+
+        for (auto heap : {rtv_heap.get(), srv_heap.get()}) {
+            if (heap != nullptr && heap->Heap() != nullptr) {
+                ComPtr<ID3D12DescriptorHeap> heap_ref{heap->Heap()};
+                deferred.release(heap_ref);
+            }
+        }
+
+        deferred.release(texture);
+        rtv_heap.reset();
+        srv_heap.reset();
+    }
+
     virtual ~TextureContext() {
         reset();
     }
@@ -0,0 +1,120 @@
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+#include "TimestampQueries.hpp"
+
+namespace d3d12 {
+bool TimestampQueries::setup(ID3D12Device* device, ID3D12CommandQueue* queue) {
+    if (device == nullptr || queue == nullptr) {
+        return false;
+    }
+
+    constexpr auto total_queries = GPU_PROFILER_FRAMES * GPU_PROFILER_MAX_TIMESTAMPS;
+
+    D3D12_QUERY_HEAP_DESC heap_desc{};
+    heap_desc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+    heap_desc.Count = total_queries;
+
+    if (FAILED(device->CreateQueryHeap(&heap_desc, IID_PPV_ARGS(&this->query_heap)))) {
+        spdlog::error("[TimestampQueries] Failed to create query heap");
+        return false;
+    }
+
+    D3D12_HEAP_PROPERTIES heap_props{};
+    heap_props.Type = D3D12_HEAP_TYPE_READBACK;
+
+    D3D12_RESOURCE_DESC buffer_desc{};
+    buffer_desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    buffer_desc.Width = total_queries * sizeof(uint64_t);
+    buffer_desc.Height = 1;
+    buffer_desc.DepthOrArraySize = 1;
+    buffer_desc.MipLevels = 1;
+    buffer_desc.SampleDesc.Count = 1;
+    buffer_desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+    if (FAILED(device->CreateCommittedResource(&heap_props, D3D12_HEAP_FLAG_NONE, &buffer_desc, 
+        D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&this->readback)))) 
+    {
+        spdlog::error("[TimestampQueries] Failed to create readback buffer");
+        this->query_heap.Reset();
+        return false;
+    }
+
+    if (FAILED(this->readback->Map(0, nullptr, (void**)&this->mapped))) {
+        spdlog::error("[TimestampQueries] Failed to map readback buffer");
+        this->readback.Reset();
+        this->query_heap.Reset();
+        return false;
+    }
+
+    for (auto& ctx : this->resolve) {
+        ctx.setup(device, L"FF7Plugin TimestampQueries");
+    }
+
+    this->queue = queue;
+
+    if (FAILED(queue->GetTimestampFrequency(&this->frequency))) {
+        this->frequency = 0;
+    }
+
+    return true;
+}
+
+void TimestampQueries::retire(DeferredRelease& deferred) {
+    if (this->readback != nullptr && this->mapped != nullptr) {
+        this->readback->Unmap(0, nullptr);
+    }
+
+    for (auto& ctx : this->resolve) {
+        ctx.retire(deferred);
+    }
+
+    deferred.release(this->query_heap);
+    deferred.release(this->readback);
+    this->mapped = nullptr;
+    this->queue = nullptr;
+}
+
+bool TimestampQueries::begin_frame(uint32_t slot) {
+    if (this->query_heap == nullptr) {
+        return false;
+    }
+
+    auto& ctx = this->resolve[slot];
+
+    if (!ctx.is_complete()) {
+        return false;
+    }
+
+    // Fence has passed so this only resets the allocator and list
+    ctx.wait(0);
+    return true;
+}
+
+void TimestampQueries::timestamp(uint32_t slot, uint32_t index, Context ctx) {
+    ctx->EndQuery(this->query_heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, slot * GPU_PROFILER_MAX_TIMESTAMPS + index);
+}
+
+bool TimestampQueries::end_frame(uint32_t slot, uint32_t count) {
+    if (count == 0) {
+        return false;
+    }
+
+    auto& ctx = this->resolve[slot];
+    const auto first = slot * GPU_PROFILER_MAX_TIMESTAMPS;
+
+    ctx.cmd_list->ResolveQueryData(this->query_heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, first, count, this->readback.Get(), first * sizeof(uint64_t));
+    ctx.has_commands = true;
+    return ctx.execute(this->queue);
+}
+
+bool TimestampQueries::read(uint32_t slot, uint32_t count, uint64_t* out, uint64_t& frequency) {
+    if (this->mapped == nullptr || !this->resolve[slot].is_complete()) {
+        return false;
+    }
+
+    memcpy(out, this->mapped + slot * GPU_PROFILER_MAX_TIMESTAMPS, count * sizeof(uint64_t));
+    frequency = this->frequency;
+    return true;
+}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <array>
+#include <d3d12.h>
+
+#include "../GpuProfiler.hpp"
+#include "CommandContext.hpp"
+#include "DeferredRelease.hpp"
+
+namespace d3d12 {
+// GpuProfiler query backend.
+// Timestamps are written into whichever command list the profiled work is recorded into,
+// then each frame slot resolves them with its own small command list into a persistently
+// mapped readback buffer, which is read once that list's fence has passed.
+struct TimestampQueries {
+    using Context = ID3D12GraphicsCommandList*;
+
+    bool setup(ID3D12Device* device, ID3D12CommandQueue* queue);
+    void retire(DeferredRelease& deferred);
+    bool is_setup() const { return query_heap != nullptr; }
+
+    bool begin_frame(uint32_t slot);
+    void timestamp(uint32_t slot, uint32_t index, Context ctx);
+    bool end_frame(uint32_t slot, uint32_t count);
+    bool read(uint32_t slot, uint32_t count, uint64_t* out, uint64_t& frequency);
+
+private:
+    ComPtr<ID3D12QueryHeap> query_heap{};
+    ComPtr<ID3D12Resource> readback{};
+    const uint64_t* mapped{nullptr};
+    ID3D12CommandQueue* queue{nullptr};
+    uint64_t frequency{0};
+
+    std::array<CommandContext, GPU_PROFILER_FRAMES> resolve{};
+};
+}
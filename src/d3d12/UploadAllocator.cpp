@@ -0,0 +1,71 @@
+#include <spdlog/spdlog.h>
+
+#include "UploadAllocator.hpp"
+
+namespace d3d12 {
+DirectX::GraphicsResource UploadAllocator::allocate(ID3D12Device* device, size_t size, size_t alignment) {
+    if (memory == nullptr) {
+        if (device == nullptr) {
+            return {};
+        }
+
+        spdlog::info("[UploadAllocator] Creating GraphicsMemory");
+
+        try {
+            memory = std::make_unique<DirectX::DX12::GraphicsMemory>(device);
+        } catch(...) {
+            spdlog::error("[UploadAllocator] Failed to create GraphicsMemory");
+            return {};
+        }
+    }
+
+    stats.bytes_this_frame += size;
+    stats.bytes_total += size;
+    ++stats.allocations_this_frame;
+    ++stats.allocations_total;
+
+    return memory->Allocate(size, alignment);
+}
+
+void UploadAllocator::on_present(ID3D12CommandQueue* queue) {
+    if (memory == nullptr || queue == nullptr) {
+        return;
+    }
+
+    stats.bytes_last_frame = stats.bytes_this_frame;
+
+    if (stats.allocations_this_frame > 0) {
+        // Fences the pages used this frame so they can be recycled once the GPU is done with them
+        memory->Commit(queue);
+        ++stats.commits;
+
+        stats.bytes_this_frame = 0;
+        stats.allocations_this_frame = 0;
+        idle_frames = 0;
+        needs_trim = true;
+        return;
+    }
+
+    if (!needs_trim || ++idle_frames < idle_frames_before_trim) {
+        return;
+    }
+
+    // Commit once more to retire pages whose fences have passed, then drop them
+    memory->Commit(queue);
+    memory->GarbageCollect();
+
+    ++stats.trims;
+    needs_trim = false;
+    idle_frames = 0;
+
+    spdlog::info("[UploadAllocator] Trimmed upload pages after {} idle frames", idle_frames_before_trim);
+}
+
+void UploadAllocator::reset() {
+    memory.reset();
+    idle_frames = 0;
+    needs_trim = false;
+    stats.bytes_this_frame = 0;
+    stats.allocations_this_frame = 0;
+}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include <d3d12.h>
+
+#include <GraphicsMemory.h>
+
+namespace d3d12 {
+// Per-frame upload heap allocator backed by DirectXTK12's GraphicsMemory.
+// GraphicsMemory is only created on the first allocate() call so features that never
+// upload anything cost nothing, and its pages get trimmed after a number of presents
+// without any allocations (Upload_Trim_Idle_Frames in ff7plugin.txt).
+struct UploadAllocator {
+    struct Stats {
+        uint64_t bytes_this_frame{0};
+        uint64_t bytes_last_frame{0};
+        uint64_t bytes_total{0};
+        uint32_t allocations_this_frame{0};
+        uint32_t allocations_total{0};
+        uint32_t commits{0};
+        uint32_t trims{0};
+    };
+
+    DirectX::GraphicsResource allocate(ID3D12Device* device, size_t size, size_t alignment = 16);
+
+    // Call once per present, after all of the frame's uploads have been recorded and executed
+    void on_present(ID3D12CommandQueue* queue);
+    void reset();
+
+    bool is_active() const { return memory != nullptr; }
+    const Stats& get_stats() const { return stats; }
+
+    void set_idle_frames_before_trim(uint32_t frames) { idle_frames_before_trim = frames; }
+    uint32_t get_idle_frames_before_trim() const { return idle_frames_before_trim; }
+
+    virtual ~UploadAllocator() { reset(); }
+
+private:
+    std::unique_ptr<DirectX::DX12::GraphicsMemory> memory{};
+    Stats stats{};
+    uint32_t idle_frames_before_trim{300};
+    uint32_t idle_frames{0};
+    bool needs_trim{false};
+};
+}
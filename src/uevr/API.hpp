@@ -28,6 +28,8 @@ extern "C" {
     #include "API.h"
 }
 
+#include <algorithm>
+#include <atomic>
 #include <optional>
 #include <filesystem>
 #include <string>
@@ -38,6 +40,7 @@ extern "C" {
 #include <string_view>
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <stdexcept>
 
 namespace uevr {
@@ -45,6 +48,79 @@ class API {
 private:
     static inline std::unique_ptr<API> s_instance{};
 
+    // Every SDK function table copied into one place when the API is initialized,
+    // so the wrappers below call straight through it without any lazy init on the way
+    struct alignas(64) Dispatch {
+        UEVR_PluginFunctions plugin;
+        UEVR_SDKFunctions functions;
+        UEVR_UObjectFunctions uobject;
+        UEVR_UObjectArrayFunctions uobject_array;
+        UEVR_FFieldFunctions ffield;
+        UEVR_FPropertyFunctions fproperty;
+        UEVR_UStructFunctions ustruct;
+        UEVR_UClassFunctions uclass;
+        UEVR_UFunctionFunctions ufunction;
+        UEVR_UObjectHookFunctions uobject_hook;
+        UEVR_UObjectHookMotionControllerStateFunctions mc_state;
+        UEVR_FFieldClassFunctions ffield_class;
+        UEVR_FNameFunctions fname;
+        UEVR_ConsoleFunctions console;
+        UEVR_FMallocFunctions malloc;
+        UEVR_FRenderTargetPoolHookFunctions render_target_pool_hook;
+        UEVR_FFakeStereoRenderingHookFunctions stereo_hook;
+        UEVR_FRHITexture2DFunctions frhitexture2d;
+    };
+
+    static inline Dispatch s_dispatch{};
+
+    static void bind_dispatch(const UEVR_PluginInitializeParam* param) {
+        // Tables a UEVR build doesn't provide stay zeroed
+        const auto copy = [](auto& dst, const auto* src) {
+            if (src != nullptr) {
+                dst = *src;
+            }
+        };
+
+        const auto sdk = param->sdk;
+
+        copy(s_dispatch.plugin, param->functions);
+        copy(s_dispatch.functions, sdk->functions);
+        copy(s_dispatch.uobject, sdk->uobject);
+        copy(s_dispatch.uobject_array, sdk->uobject_array);
+        copy(s_dispatch.ffield, sdk->ffield);
+        copy(s_dispatch.fproperty, sdk->fproperty);
+        copy(s_dispatch.ustruct, sdk->ustruct);
+        copy(s_dispatch.uclass, sdk->uclass);
+        copy(s_dispatch.ufunction, sdk->ufunction);
+        copy(s_dispatch.uobject_hook, sdk->uobject_hook);
+        copy(s_dispatch.ffield_class, sdk->ffield_class);
+        copy(s_dispatch.fname, sdk->fname);
+        copy(s_dispatch.console, sdk->console);
+        copy(s_dispatch.malloc, sdk->malloc);
+        copy(s_dispatch.render_target_pool_hook, sdk->render_target_pool_hook);
+        copy(s_dispatch.stereo_hook, sdk->stereo_hook);
+        copy(s_dispatch.frhitexture2d, sdk->frhitexture2d);
+
+        if (sdk->uobject_hook != nullptr) {
+            copy(s_dispatch.mc_state, sdk->uobject_hook->mc_state);
+        }
+    }
+
+    // For the static_class() helpers. Native classes are never garbage collected, so once one is found
+    // it's kept for good, but a lookup made before the class exists isn't remembered and is tried again.
+    // After the first hit this is a single load, no lookup and no static guard.
+    template <typename T>
+    static T* find_static_class(std::atomic<T*>& cache, const wchar_t* path) {
+        auto c = cache.load(std::memory_order_acquire);
+
+        if (c == nullptr) {
+            c = (T*)s_dispatch.uobject_array.find_uobject(path);
+            cache.store(c, std::memory_order_release);
+        }
+
+        return c;
+    }
+
 public:
     // ALWAYS call initialize first in uevr_plugin_initialize
     static auto& initialize(const UEVR_PluginInitializeParam* param) {
@@ -56,6 +132,7 @@ public:
             return s_instance;
         }
 
+        bind_dispatch(param);
         s_instance = std::make_unique<API>(param);
         return s_instance;
     }
@@ -89,7 +166,7 @@ public:
     }
 
     std::filesystem::path get_persistent_dir(std::optional<std::wstring> file = std::nullopt) {
-        static const auto fn = param()->functions->get_persistent_dir;
+        const auto fn = s_dispatch.plugin.get_persistent_dir;
         const auto size = fn(nullptr, 0);
         if (size == 0) {
             return std::filesystem::path{};
@@ -137,53 +214,53 @@ public:
 
     template<typename T = UObject>
     T* find_uobject(std::wstring_view name) {
-        static const auto fn = sdk()->uobject_array->find_uobject;
+        const auto fn = s_dispatch.uobject_array.find_uobject;
         return (T*)fn(name.data());
     }
 
     UEngine* get_engine() {
-        static const auto fn = sdk()->functions->get_uengine;
+        const auto fn = s_dispatch.functions.get_uengine;
         return (UEngine*)fn();
     }
 
     UObject* get_player_controller(int32_t index) {
-        static const auto fn = sdk()->functions->get_player_controller;
+        const auto fn = s_dispatch.functions.get_player_controller;
         return (UObject*)fn(index);
     }
 
     UObject* get_local_pawn(int32_t index) {
-        static const auto fn = sdk()->functions->get_local_pawn;
+        const auto fn = s_dispatch.functions.get_local_pawn;
         return (UObject*)fn(index);
     }
 
     UObject* spawn_object(UClass* klass, UObject* outer) {
-        static const auto fn = sdk()->functions->spawn_object;
+        const auto fn = s_dispatch.functions.spawn_object;
         return (UObject*)fn(klass->to_handle(), outer->to_handle());
     }
 
     void execute_command(std::wstring_view command) {
-        static const auto fn = sdk()->functions->execute_command;
+        const auto fn = s_dispatch.functions.execute_command;
         fn(command.data());
     }
 
     void execute_command_ex(UWorld* world, std::wstring_view command, void* output_device) {
-        static const auto fn = sdk()->functions->execute_command_ex;
+        const auto fn = s_dispatch.functions.execute_command_ex;
         fn((UEVR_UObjectHandle)world, command.data(), output_device);
     }
 
     FUObjectArray* get_uobject_array() {
-        static const auto fn = sdk()->functions->get_uobject_array;
+        const auto fn = s_dispatch.functions.get_uobject_array;
         return (FUObjectArray*)fn();
     }
 
     FConsoleManager* get_console_manager() {
-        static const auto fn = sdk()->functions->get_console_manager;
+        const auto fn = s_dispatch.functions.get_console_manager;
         return (FConsoleManager*)fn();
     }
 
     struct FMalloc {
         static FMalloc* get() {
-            static const auto fn = initialize()->get;
+            const auto fn = s_dispatch.malloc.get;
             return (FMalloc*)fn();
         }
 
@@ -193,29 +270,19 @@ public:
         using FMallocSizeT = uint32_t; // because of C89
 
         void* malloc(FMallocSizeT size, uint32_t alignment = 0) {
-            static const auto fn = initialize()->malloc;
+            const auto fn = s_dispatch.malloc.malloc;
             return fn(to_handle(), size, alignment);
         }
         
         void* realloc(void* original, FMallocSizeT size, uint32_t alignment = 0) {
-            static const auto fn = initialize()->realloc;
+            const auto fn = s_dispatch.malloc.realloc;
             return fn(to_handle(), original, size, alignment);
         }
 
         void free(void* original) {
-            static const auto fn = initialize()->free;
+            const auto fn = s_dispatch.malloc.free;
             fn(to_handle(), original);
         }
-
-    private:
-        static inline const UEVR_FMallocFunctions* s_functions{nullptr};
-        static inline const UEVR_FMallocFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->malloc;
-            }
-
-            return s_functions;
-        }
     };
 
     struct FName {
@@ -229,12 +296,12 @@ public:
 
         FName() = default;
         FName(std::wstring_view name, EFindName find_type = EFindName::Add) {
-            static const auto fn = initialize()->constructor;
+            const auto fn = s_dispatch.fname.constructor;
             fn(to_handle(), name.data(), (uint32_t)find_type);
         }
 
         std::wstring to_string() const {
-            static const auto fn = initialize()->to_string;
+            const auto fn = s_dispatch.fname.to_string;
             const auto size = fn(to_handle(), nullptr, 0);
             if (size == 0) {
                 return L"";
@@ -247,16 +314,6 @@ public:
 
         int32_t comparison_index{};
         int32_t number{};
-
-    private:
-        static inline const UEVR_FNameFunctions* s_functions{nullptr};
-        static inline const UEVR_FNameFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->fname;
-            }
-
-            return s_functions;
-        }
     };
 
     struct UObject {
@@ -264,39 +321,39 @@ public:
         inline UEVR_UObjectHandle to_handle() const { return (UEVR_UObjectHandle)this; }
 
         static UClass* static_class() {
-            static auto result = API::get()->find_uobject<UClass>(L"Class /Script/CoreUObject.Object");
-            return result;
+            static constinit std::atomic<UClass*> s_class{nullptr};
+            return find_static_class(s_class, L"Class /Script/CoreUObject.Object");
         }
 
         inline UClass* get_class() const {
-            static const auto fn = initialize()->get_class;
+            const auto fn = s_dispatch.uobject.get_class;
             return (UClass*)fn(to_handle());
         }
 
         inline UObject* get_outer() const {
-            static const auto fn = initialize()->get_outer;
+            const auto fn = s_dispatch.uobject.get_outer;
             return (UObject*)fn(to_handle());
         }
 
         inline bool is_a(UClass* cmp) const {
-            static const auto fn = initialize()->is_a;
+            const auto fn = s_dispatch.uobject.is_a;
             return fn(to_handle(), cmp->to_handle());
         }
 
         void process_event(UFunction* function, void* params) {
-            static const auto fn = initialize()->process_event;
+            const auto fn = s_dispatch.uobject.process_event;
             fn(to_handle(), function->to_handle(), params);
         }
 
         void call_function(std::wstring_view name, void* params) {
-            static const auto fn = initialize()->call_function;
+            const auto fn = s_dispatch.uobject.call_function;
             fn(to_handle(), name.data(), params);
         }
 
         // Pointer that points to the address of the data within the object, not the data itself
         template<typename T>
         T* get_property_data(std::wstring_view name) const {
-            static const auto fn = initialize()->get_property_data;
+            const auto fn = s_dispatch.uobject.get_property_data;
             return (T*)fn(to_handle(), name.data());
         }
 
@@ -313,7 +370,7 @@ public:
         }
 
         FName* get_fname() const {
-            static const auto fn = initialize()->get_fname;
+            const auto fn = s_dispatch.uobject.get_fname;
             return (FName*)fn(to_handle());
         }
 
@@ -332,16 +389,6 @@ public:
 
             return c->get_fname()->to_string() + L' ' + obj_name;
         }
-
-    private:
-        static inline const UEVR_UObjectFunctions* s_functions{nullptr};
-        inline static const UEVR_UObjectFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->uobject;
-            }
-
-            return s_functions;
-        }
     };
 
     struct UStruct : public UObject {
@@ -349,12 +396,12 @@ public:
         inline UEVR_UStructHandle to_handle() const { return (UEVR_UStructHandle)this; }
 
         static UClass* static_class() {
-            static auto result = API::get()->find_uobject<UClass>(L"Class /Script/CoreUObject.Struct");
-            return result;
+            static constinit std::atomic<UClass*> s_class{nullptr};
+            return find_static_class(s_class, L"Class /Script/CoreUObject.Struct");
         }
 
         UStruct* get_super_struct() const {
-            static const auto fn = initialize()->get_super_struct;
+            const auto fn = s_dispatch.ustruct.get_super_struct;
             return (UStruct*)fn(to_handle());
         }
 
@@ -363,25 +410,15 @@ public:
         }
         
         UFunction* find_function(std::wstring_view name) const {
-            static const auto fn = initialize()->find_function;
+            const auto fn = s_dispatch.ustruct.find_function;
             return (UFunction*)fn(to_handle(), name.data());
         }
 
         // Not an array, it's a linked list. Meant to call ->get_next() until nullptr
         FField* get_child_properties() const {
-            static const auto fn = initialize()->get_child_properties;
+            const auto fn = s_dispatch.ustruct.get_child_properties;
             return (FField*)fn(to_handle());
         }
-
-    private:
-        static inline const UEVR_UStructFunctions* s_functions{nullptr};
-        inline static const UEVR_UStructFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->ustruct;
-            }
-
-            return s_functions;
-        }
     };
 
     struct UClass : public UStruct {
@@ -389,18 +426,18 @@ public:
         inline UEVR_UClassHandle to_handle() const { return (UEVR_UClassHandle)this; }
 
         static UClass* static_class() {
-            static auto result = API::get()->find_uobject<UClass>(L"Class /Script/CoreUObject.Class");
-            return result;
+            static constinit std::atomic<UClass*> s_class{nullptr};
+            return find_static_class(s_class, L"Class /Script/CoreUObject.Class");
         }
 
         UObject* get_class_default_object() const {
-            static const auto fn = initialize()->get_class_default_object;
+            const auto fn = s_dispatch.uclass.get_class_default_object;
             return (UObject*)fn(to_handle());
         }
 
         std::vector<UObject*> get_objects_matching(bool allow_default = false) const {
-            static auto activate_fn = API::get()->sdk()->uobject_hook->activate;
-            static auto fn = API::get()->sdk()->uobject_hook->get_objects_by_class;
+            const auto activate_fn = s_dispatch.uobject_hook.activate;
+            const auto fn = s_dispatch.uobject_hook.get_objects_by_class;
             activate_fn();
             std::vector<UObject*> result{};
             const auto size = fn(to_handle(), nullptr, 0, allow_default);
@@ -414,9 +451,68 @@ public:
             return result;
         }
 
+        // One walk of the object array into caller owned memory, no allocation.
+        // Returns how many were written, if that's out.size() there may have been more.
+        size_t get_objects_matching(std::span<UObject*> out, bool allow_default = false) const {
+            if (out.empty()) {
+                return 0;
+            }
+
+            const auto activate_fn = s_dispatch.uobject_hook.activate;
+            const auto fn = s_dispatch.uobject_hook.get_objects_by_class;
+            activate_fn();
+
+            const auto size = fn(to_handle(), (UEVR_UObjectHandle*)out.data(), (unsigned int)out.size(), allow_default);
+            return size > 0 ? (std::min)((size_t)size, out.size()) : 0;
+        }
+
+        // Same, into a buffer that's meant to be reused: its capacity is used as is, an unused buffer starts
+        // with room for 64. Only a walk that fills it completely needs the count to know if there were more,
+        // and the buffer is then grown by half again so the next call with as many objects is one walk.
+        void get_objects_matching(std::vector<UObject*>& out, bool allow_default = false) const {
+            if (out.capacity() == 0) {
+                out.reserve(64);
+            }
+
+            out.resize(out.capacity());
+
+            const auto activate_fn = s_dispatch.uobject_hook.activate;
+            const auto fn = s_dispatch.uobject_hook.get_objects_by_class;
+            activate_fn();
+
+            auto n = (size_t)(std::max)(fn(to_handle(), (UEVR_UObjectHandle*)out.data(), (unsigned int)out.size(), allow_default), 0);
+
+            // More than was asked for is already the count
+            if (n == out.size()) {
+                n = (size_t)(std::max)(fn(to_handle(), nullptr, 0, allow_default), 0);
+            }
+
+            if (n > out.size()) {
+                out.resize(n + n / 2);
+                n = get_objects_matching(std::span<UObject*>{out}, allow_default);
+            } else if (n == out.size()) {
+                out.reserve(n + n / 2);
+            }
+
+            out.resize(n);
+        }
+
+        // Calls visit(UObject*) for every match, through a per thread buffer that's reused between calls.
+        // Don't enumerate from inside visit, that would overwrite the buffer being walked.
+        template<typename F>
+        void for_each_object_matching(F&& visit, bool allow_default = false) const {
+            thread_local std::vector<UObject*> buffer{};
+
+            get_objects_matching(buffer, allow_default);
+
+            for (const auto object : buffer) {
+                visit(object);
+            }
+        }
+
         UObject* get_first_object_matching(bool allow_default = false) const {
-            static auto activate_fn = API::get()->sdk()->uobject_hook->activate;
-            static auto fn = API::get()->sdk()->uobject_hook->get_first_object_by_class;
+            const auto activate_fn = s_dispatch.uobject_hook.activate;
+            const auto fn = s_dispatch.uobject_hook.get_first_object_by_class;
             activate_fn();
             return (UObject*)fn(to_handle(), allow_default);
         }
@@ -432,16 +528,6 @@ public:
         T* get_first_object_matching(bool allow_default = false) const {
             return (T*)get_first_object_matching(allow_default);
         }
-
-    private:
-        static inline const UEVR_UClassFunctions* s_functions{nullptr};
-        inline static const UEVR_UClassFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->uclass;
-            }
-
-            return s_functions;
-        }
     };
 
     struct UFunction : public UStruct {
@@ -449,8 +535,8 @@ public:
         inline UEVR_UFunctionHandle to_handle() const { return (UEVR_UFunctionHandle)this; }
 
         static UClass* static_class() {
-            static auto result = API::get()->find_uobject<UClass>(L"Class /Script/CoreUObject.Function");
-            return result;
+            static constinit std::atomic<UClass*> s_class{nullptr};
+            return find_static_class(s_class, L"Class /Script/CoreUObject.Function");
         }
 
         void call(UObject* obj, void* params) {
@@ -462,19 +548,9 @@ public:
         }
 
         void* get_native_function() const {
-            static const auto fn = initialize()->get_native_function;
+            const auto fn = s_dispatch.ufunction.get_native_function;
             return fn(to_handle());
         }
-
-    private:
-        static inline const UEVR_UFunctionFunctions* s_functions{nullptr};
-        inline static const UEVR_UFunctionFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->ufunction;
-            }
-
-            return s_functions;
-        }
     };
 
     // Wrapper class for UField AND FField
@@ -483,29 +559,19 @@ public:
         inline UEVR_FFieldHandle to_handle() const { return (UEVR_FFieldHandle)this; }
 
         inline FField* get_next() const {
-            static const auto fn = initialize()->get_next;
+            const auto fn = s_dispatch.ffield.get_next;
             return (FField*)fn(to_handle());
         }
         
         FName* get_fname() const {
-            static const auto fn = initialize()->get_fname;
+            const auto fn = s_dispatch.ffield.get_fname;
             return (FName*)fn(to_handle());
         }
 
         FFieldClass* get_class() const {
-            static const auto fn = initialize()->get_class;
+            const auto fn = s_dispatch.ffield.get_class;
             return (FFieldClass*)fn(to_handle());
         }
-
-    private:
-        static inline const UEVR_FFieldFunctions* s_functions{nullptr};
-        static inline const UEVR_FFieldFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->ffield;
-            }
-
-            return s_functions;
-        }
     };
 
     // Wrapper class for FProperty AND UProperty
@@ -514,19 +580,9 @@ public:
         inline UEVR_FPropertyHandle to_handle() const { return (UEVR_FPropertyHandle)this; }
 
         int32_t get_offset() const {
-            static const auto fn = initialize()->get_offset;
+            const auto fn = s_dispatch.fproperty.get_offset;
             return fn(to_handle());
         }
-
-    private:
-        static inline const UEVR_FPropertyFunctions* s_functions{nullptr};
-        static inline const UEVR_FPropertyFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->fproperty;
-            }
-
-            return s_functions;
-        }
     };
 
     struct FFieldClass {
@@ -534,23 +590,13 @@ public:
         inline UEVR_FFieldClassHandle to_handle() const { return (UEVR_FFieldClassHandle)this; }
 
         FName* get_fname() const {
-            static const auto fn = initialize()->get_fname;
+            const auto fn = s_dispatch.ffield_class.get_fname;
             return (FName*)fn(to_handle());
         }
 
         std::wstring get_name() const {
             return get_fname()->to_string();
         }
-
-    private:
-        static inline const UEVR_FFieldClassFunctions* s_functions{nullptr};
-        static inline const UEVR_FFieldClassFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->ffield_class;
-            }
-
-            return s_functions;
-        }
     };
 
     struct ConsoleObjectElement {
@@ -565,34 +611,24 @@ public:
         inline UEVR_FConsoleManagerHandle to_handle() const { return (UEVR_FConsoleManagerHandle)this; }
 
         TArray<ConsoleObjectElement>& get_console_objects() {
-            static const auto fn = initialize()->get_console_objects;
+            const auto fn = s_dispatch.console.get_console_objects;
             return *(TArray<ConsoleObjectElement>*)fn(to_handle());
         }
 
         IConsoleObject* find_object(std::wstring_view name) {
-            static const auto fn = initialize()->find_object;
+            const auto fn = s_dispatch.console.find_object;
             return (IConsoleObject*)fn(to_handle(), name.data());
         }
 
         IConsoleVariable* find_variable(std::wstring_view name) {
-            static const auto fn = initialize()->find_variable;
+            const auto fn = s_dispatch.console.find_variable;
             return (IConsoleVariable*)fn(to_handle(), name.data());
         }
 
         IConsoleCommand* find_command(std::wstring_view name) {
-            static const auto fn = initialize()->find_command;
+            const auto fn = s_dispatch.console.find_command;
             return (IConsoleCommand*)fn(to_handle(), name.data());
         }
-
-    private:
-        static inline const UEVR_ConsoleFunctions* s_functions{nullptr};
-        static inline const UEVR_ConsoleFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->console;
-            }
-
-            return s_functions;
-        }
     };
 
     struct IConsoleObject {
@@ -600,19 +636,9 @@ public:
         inline UEVR_IConsoleObjectHandle to_handle() const { return (UEVR_IConsoleObjectHandle)this; }
 
         IConsoleCommand* as_command() {
-            static const auto fn = initialize()->as_command;
+            const auto fn = s_dispatch.console.as_command;
             return (IConsoleCommand*)fn(to_handle());
         }
-
-    private:
-        static inline const UEVR_ConsoleFunctions* s_functions{nullptr};
-        static inline const UEVR_ConsoleFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->console;
-            }
-
-            return s_functions;
-        }
     };
 
     struct IConsoleVariable : public IConsoleObject {
@@ -620,12 +646,12 @@ public:
         inline UEVR_IConsoleVariableHandle to_handle() const { return (UEVR_IConsoleVariableHandle)this; }
 
         void set(std::wstring_view value) {
-            static const auto fn = initialize()->variable_set;
+            const auto fn = s_dispatch.console.variable_set;
             fn(to_handle(), value.data());
         }
 
         void set_ex(std::wstring_view value, uint32_t flags = 0x80000000) {
-            static const auto fn = initialize()->variable_set_ex;
+            const auto fn = s_dispatch.console.variable_set_ex;
             fn(to_handle(), value.data(), flags);
         }
 
@@ -638,24 +664,14 @@ public:
         }
 
         int get_int() const {
-            static const auto fn = initialize()->variable_get_int;
+            const auto fn = s_dispatch.console.variable_get_int;
             return fn(to_handle());
         }
 
         float get_float() const {
-            static const auto fn = initialize()->variable_get_float;
+            const auto fn = s_dispatch.console.variable_get_float;
             return fn(to_handle());
         }
-
-    private:
-        static inline const UEVR_ConsoleFunctions* s_functions{nullptr};
-        static inline const UEVR_ConsoleFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->console;
-            }
-
-            return s_functions;
-        }
     };
 
     struct IConsoleCommand : public IConsoleObject {
@@ -663,19 +679,9 @@ public:
         inline UEVR_IConsoleCommandHandle to_handle() const { return (UEVR_IConsoleCommandHandle)this; }
 
         void execute(std::wstring_view args) {
-            static const auto fn = initialize()->command_execute;
+            const auto fn = s_dispatch.console.command_execute;
             fn(to_handle(), args.data());
         }
-    
-    private:
-        static inline const UEVR_ConsoleFunctions* s_functions{nullptr};
-        static inline const UEVR_ConsoleFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->console;
-            }
-
-            return s_functions;
-        }
     };
 
     // TODO
@@ -748,19 +754,9 @@ public:
         inline UEVR_FRHITexture2DHandle to_handle() const { return (UEVR_FRHITexture2DHandle)this; }
 
         void* get_native_resource() const {
-            static const auto fn = initialize()->get_native_resource;
+            const auto fn = s_dispatch.frhitexture2d.get_native_resource;
             return fn(to_handle());
         }
-
-    private:
-        static inline const UEVR_FRHITexture2DFunctions* s_functions{nullptr};
-        static inline const UEVR_FRHITexture2DFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->frhitexture2d;
-            }
-
-            return s_functions;
-        }
     };
 
 public:
@@ -769,12 +765,12 @@ public:
         struct MotionControllerState;
 
         static void activate() {
-            static const auto fn = initialize()->activate;
+            const auto fn = s_dispatch.uobject_hook.activate;
             fn();
         }
 
         static bool exists(UObject* obj) {
-            static const auto fn = initialize()->exists;
+            const auto fn = s_dispatch.uobject_hook.exists;
             return fn(obj->to_handle());
         }
 
@@ -798,12 +794,12 @@ public:
         // Also, do NOT keep the pointer around, it will be invalidated at any time
         // Call it every time you need it
         static MotionControllerState* get_or_add_motion_controller_state(UObject* obj) {
-            static const auto fn = initialize()->get_or_add_motion_controller_state;
+            const auto fn = s_dispatch.uobject_hook.get_or_add_motion_controller_state;
             return (MotionControllerState*)fn(obj->to_handle());
         }
 
         static MotionControllerState* get_motion_controller_state(UObject* obj) {
-            static const auto fn = initialize()->get_motion_controller_state;
+            const auto fn = s_dispatch.uobject_hook.get_motion_controller_state;
             return (MotionControllerState*)fn(obj->to_handle());
         }
 
@@ -812,89 +808,98 @@ public:
             inline UEVR_UObjectHookMotionControllerStateHandle to_handle() const { return (UEVR_UObjectHookMotionControllerStateHandle)this; }
 
             void set_rotation_offset(const UEVR_Quaternionf* offset) {
-                static const auto fn = initialize()->set_rotation_offset;
+                const auto fn = s_dispatch.mc_state.set_rotation_offset;
                 fn(to_handle(), offset);
             }
 
             void set_location_offset(const UEVR_Vector3f* offset) {
-                static const auto fn = initialize()->set_location_offset;
+                const auto fn = s_dispatch.mc_state.set_location_offset;
                 fn(to_handle(), offset);
             }
 
             void set_hand(uint32_t hand) {
-                static const auto fn = initialize()->set_hand;
+                const auto fn = s_dispatch.mc_state.set_hand;
                 fn(to_handle(), hand);
             }
 
             void set_permanent(bool permanent) {
-                static const auto fn = initialize()->set_permanent;
+                const auto fn = s_dispatch.mc_state.set_permanent;
                 fn(to_handle(), permanent);
             }
-
-        private:
-            static inline const UEVR_UObjectHookMotionControllerStateFunctions* s_functions{nullptr};
-            static inline const UEVR_UObjectHookMotionControllerStateFunctions* initialize() {
-                if (s_functions == nullptr) {
-                    s_functions = API::get()->sdk()->uobject_hook->mc_state;
-                }
-
-                return s_functions;
-            }
         };
-
-    private:
-        static inline const UEVR_UObjectHookFunctions* s_functions{nullptr};
-        static inline const UEVR_UObjectHookFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->uobject_hook;
-            }
-
-            return s_functions;
-        }
     };
 
     struct RenderTargetPoolHook {
         static void activate() {
-            static const auto fn = initialize()->activate;
+            const auto fn = s_dispatch.render_target_pool_hook.activate;
             fn();
         }
 
         static IPooledRenderTarget* get_render_target(const wchar_t* name) {
-            static const auto fn = initialize()->get_render_target;
+            const auto fn = s_dispatch.render_target_pool_hook.get_render_target;
             return (IPooledRenderTarget*)fn(name);
         }
 
-    private:
-        static inline const UEVR_FRenderTargetPoolHookFunctions* s_functions{nullptr};
-        static inline const UEVR_FRenderTargetPoolHookFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->render_target_pool_hook;
+        // A pooled render target registered by name once.
+        // The hook is activated on first use instead of every frame. The pool can free or recycle the target
+        // at any time and the SDK has no reallocation callback, so get() asks the pool every call and the
+        // result is only good until the next one.
+        // The generation changes whenever the pool hands out a different non-null target for the name,
+        // so callers can skip per-target work while it stays the same. get_cached() is for comparing
+        // against, never for writing through.
+        // Use the handle from one thread only (the render thread for this hook).
+        class Handle {
+        public:
+            Handle(std::wstring name) : m_name{std::move(name)} {}
+
+            IPooledRenderTarget* get() {
+                if (!s_activated) {
+                    activate();
+                    s_activated = true;
+                }
+
+                const auto rt = get_render_target(m_name.c_str());
+
+                // Going missing and coming back as the same target isn't a new one
+                if (rt != nullptr && rt != m_last_valid) {
+                    m_last_valid = rt;
+                    ++m_generation;
+                }
+
+                m_last = rt;
+                return rt;
             }
 
-            return s_functions;
+            // What the last get() returned, no SDK call
+            IPooledRenderTarget* get_cached() const { return m_last; }
+            uint32_t get_generation() const { return m_generation; }
+            const std::wstring& get_name() const { return m_name; }
+
+        private:
+            std::wstring m_name{};
+            IPooledRenderTarget* m_last{nullptr};
+            IPooledRenderTarget* m_last_valid{nullptr};
+            uint32_t m_generation{0};
+        };
+
+        static Handle register_render_target(std::wstring name) {
+            return Handle{std::move(name)};
         }
+
+    private:
+        static inline bool s_activated{false};
     };
 
     struct StereoHook {
         static FRHITexture2D* get_scene_render_target() {
-            static const auto fn = initialize()->get_scene_render_target;
+            const auto fn = s_dispatch.stereo_hook.get_scene_render_target;
             return (FRHITexture2D*)fn();
         }
 
         static FRHITexture2D* get_ui_render_target() {
-            static const auto fn = initialize()->get_ui_render_target;
+            const auto fn = s_dispatch.stereo_hook.get_ui_render_target;
             return (FRHITexture2D*)fn();
         }
-
-    private:
-        static inline const UEVR_FFakeStereoRenderingHookFunctions* s_functions{nullptr};
-        static inline const UEVR_FFakeStereoRenderingHookFunctions* initialize() {
-            if (s_functions == nullptr) {
-                s_functions = API::get()->sdk()->stereo_hook;
-            }
-
-            return s_functions;
-        }
     };
 
 private:
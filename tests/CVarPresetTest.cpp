@@ -0,0 +1,236 @@
+#include <string>
+#include <vector>
+
+#include "CVarPreset.hpp"
+
+#include "FakeUEVR.hpp"
+#include "Test.hpp"
+
+namespace {
+using uevr::API;
+
+// A console map with every slot in use, enough for ConsoleIndex to find the fake cvars by name
+struct FakeConsole {
+    struct Map {
+        API::ConsoleObjectElement* data{nullptr};
+        int32_t count{0};
+        int32_t capacity{0};
+        ConsoleIndex::AllocationFlags flags{};
+    };
+
+    FakeConsole(std::vector<std::pair<std::wstring, fake::CVar*>> vars) : names(vars.size()), elements(vars.size()) {
+        for (size_t i = 0; i < vars.size(); ++i) {
+            names[i] = vars[i].first;
+            elements[i].key = names[i].data();
+            elements[i].value = (API::IConsoleObject*)vars[i].second;
+            map.flags.inline_data[i / 32] |= 1u << (i % 32);
+        }
+
+        map.data = elements.data();
+        map.count = map.capacity = map.flags.num_bits = map.flags.max_bits = (int32_t)vars.size();
+        index.update((API::FConsoleManager*)this);
+    }
+
+    Map map{};
+    std::vector<std::wstring> names{};
+    std::vector<API::ConsoleObjectElement> elements{};
+    ConsoleIndex index{};
+};
+
+uint32_t g_warnings{0};
+
+void count_warning(const char*, ...) {
+    ++g_warnings;
+}
+
+void install() {
+    [[maybe_unused]] static const bool installed = [] {
+        auto& uevr = fake::get();
+        fake::CVar::install(uevr.console);
+        uevr.console.get_console_objects = [](UEVR_FConsoleManagerHandle mgr) {
+            return (UEVR_TArrayHandle)&((FakeConsole*)mgr)->map;
+        };
+        uevr.console.as_command = [](UEVR_IConsoleObjectHandle) { return (UEVR_IConsoleCommandHandle)nullptr; };
+        uevr.plugin.log_warn = count_warning;
+        uevr.install();
+        return true;
+    }();
+}
+
+CVarPreset make_preset(std::vector<CVarPreset::Value> values) {
+    return CVarPreset{L"test", std::move(values)};
+}
+}
+
+TEST_CASE(applies_and_restores_numbers) {
+    install();
+
+    fake::CVar quality{};
+    quality.i = 3;
+    fake::CVar scale{};
+    scale.is_int = false;
+    scale.f = 100.0f;
+    fake::CVar same{};
+    same.i = 1;
+
+    FakeConsole console{{{L"sg.Quality", &quality}, {L"r.Scale", &scale}, {L"r.Same", &same}}};
+
+    CVarPresetApplier applier{};
+    applier.apply(make_preset({{L"SG.QUALITY", L"1"}, {L"r.Scale", L"82.5"}, {L"r.Same", L"1"}, {L"r.Gone", L"2"}}), console.index);
+
+    CHECK(applier.is_applied());
+    CHECK_EQ(quality.i, 1);
+    CHECK_EQ(scale.f, 82.5f);
+    CHECK_EQ(same.sets, 0u);
+    CHECK_EQ(applier.get_stats().written, 2u);
+    CHECK_EQ(applier.get_stats().unchanged, 1u);
+    CHECK_EQ(applier.get_stats().missing, 1u);
+    CHECK_EQ(applier.get_stats().mismatched, 0u);
+
+    applier.restore();
+    CHECK(!applier.is_applied());
+    CHECK_EQ(quality.i, 3);
+    CHECK_EQ(scale.f, 100.0f);
+    CHECK_EQ(applier.get_stats().restored, 2u);
+}
+
+TEST_CASE(fractions_on_int_cvars_are_reported_and_still_restored) {
+    install();
+
+    fake::CVar on{};
+    on.i = 2;
+
+    FakeConsole console{{{L"r.On", &on}}};
+
+    const auto warnings = g_warnings;
+    CVarPresetApplier applier{};
+    applier.apply(make_preset({{L"r.On", L"0.5"}}), console.index);
+
+    // The engine truncates it, the readback is what gets compared on restore
+    CHECK_EQ(on.i, 0);
+    CHECK_EQ(applier.get_stats().mismatched, 1u);
+    CHECK_EQ(g_warnings, warnings + 1);
+
+    applier.restore();
+    CHECK_EQ(on.i, 2);
+    CHECK_EQ(applier.get_stats().restored, 1u);
+    CHECK_EQ(applier.get_stats().kept, 0u);
+}
+
+TEST_CASE(fraction_that_truncates_to_the_current_value_is_unchanged) {
+    install();
+
+    fake::CVar zero{};
+
+    FakeConsole console{{{L"r.Zero", &zero}}};
+
+    CVarPresetApplier applier{};
+    applier.apply(make_preset({{L"r.Zero", L"0.5"}}), console.index);
+
+    CHECK_EQ(applier.get_stats().unchanged, 1u);
+    CHECK_EQ(applier.get_stats().mismatched, 1u);
+
+    zero.i = 7;
+    applier.restore();
+    CHECK_EQ(zero.i, 7);
+}
+
+TEST_CASE(non_numeric_values_are_recorded_by_readback) {
+    install();
+
+    fake::CVar flag{};
+    fake::CVar name{};
+    name.is_string = true;
+
+    FakeConsole console{{{L"r.Flag", &flag}, {L"r.Name", &name}}};
+
+    const auto warnings = g_warnings;
+    CVarPresetApplier applier{};
+    applier.apply(make_preset({{L"r.Flag", L"7 "}, {L"r.Name", L"Epic"}}), console.index);
+
+    // "7 " doesn't parse as a number here but the engine takes it, so it's restored from its readback
+    CHECK_EQ(flag.i, 7);
+    CHECK_EQ(name.sets, 1u);
+    CHECK_EQ(applier.get_stats().written, 2u);
+    CHECK_EQ(applier.get_stats().unrestorable, 1u);
+    CHECK_EQ(g_warnings, warnings + 1);
+
+    applier.restore();
+    CHECK_EQ(flag.i, 0);
+    CHECK_EQ(applier.get_stats().restored, 1u);
+    CHECK_EQ(name.sets, 1u);
+}
+
+TEST_CASE(values_changed_elsewhere_are_kept) {
+    install();
+
+    fake::CVar scale{};
+    scale.is_int = false;
+    scale.f = 1.0f;
+
+    FakeConsole console{{{L"r.Scale", &scale}}};
+
+    CVarPresetApplier applier{};
+    applier.apply(make_preset({{L"r.Scale", L"0.25"}}), console.index);
+    scale.f = 0.3f;
+
+    applier.restore();
+    CHECK_EQ(scale.f, 0.3f);
+    CHECK_EQ(applier.get_stats().kept, 1u);
+}
+
+// The plugin's order for the VR preset and the tuner's trials on top of it, with a cvar in both
+TEST_CASE(stacked_presets_put_a_shared_cvar_back) {
+    install();
+
+    fake::CVar shadows{};
+    shadows.i = 4;
+    fake::CVar view{};
+    view.i = 90;
+
+    FakeConsole console{{{L"r.ShadowQuality", &shadows}, {L"r.ViewDistance", &view}}};
+
+    const auto vr = make_preset({{L"r.ShadowQuality", L"2"}, {L"r.ViewDistance", L"60"}});
+    CVarPresetApplier vr_applier{};
+    CVarPresetApplier tuner_applier{};
+
+    // HMD on: the VR preset first, the first trial on top
+    vr_applier.apply(vr, console.index);
+    tuner_applier.apply(make_preset({{L"r.ShadowQuality", L"1"}}), console.index);
+    CHECK_EQ(shadows.i, 1);
+    CHECK_EQ(view.i, 60);
+
+    // Next trial, apply() takes the last one off first
+    tuner_applier.apply(make_preset({{L"r.ShadowQuality", L"3"}}), console.index);
+    CHECK_EQ(shadows.i, 3);
+    CHECK_EQ(tuner_applier.get_stats().kept, 0u);
+
+    // Swapping the VR preset: the trial comes off, the new preset goes on, the trial goes back on top
+    tuner_applier.restore();
+    vr_applier.restore();
+    CHECK_EQ(shadows.i, 4);
+    vr_applier.apply(make_preset({{L"r.ShadowQuality", L"0"}}), console.index);
+    tuner_applier.apply(make_preset({{L"r.ShadowQuality", L"3"}}), console.index);
+    CHECK_EQ(shadows.i, 3);
+    CHECK_EQ(view.i, 90);
+
+    // HMD off: top down
+    tuner_applier.restore();
+    CHECK_EQ(shadows.i, 0);
+    vr_applier.restore();
+    CHECK_EQ(shadows.i, 4);
+    CHECK_EQ(view.i, 90);
+    CHECK_EQ(vr_applier.get_stats().kept, 0u);
+}
+
+TEST_CASE(formats_floats_so_they_parse_back) {
+    CHECK(CVarPresetApplier::format({3, 3.0f}) == L"3");
+    CHECK(CVarPresetApplier::format({-1, -1.0f}) == L"-1");
+
+    const auto value = 0.1f + 0.2f;
+    CHECK_EQ(std::wcstof(CVarPresetApplier::format({0, value}).c_str(), nullptr), value);
+}
+
+int main() {
+    return test::run_all();
+}
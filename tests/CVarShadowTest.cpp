@@ -0,0 +1,130 @@
+#include "CVarShadow.hpp"
+
+#include "FakeUEVR.hpp"
+#include "Test.hpp"
+
+namespace {
+void install() {
+    [[maybe_unused]] static const bool installed = [] {
+        fake::CVar::install(fake::get().console);
+        fake::get().install();
+        return true;
+    }();
+}
+}
+
+TEST_CASE(set_only_writes_on_flush) {
+    install();
+
+    fake::CVar var{};
+    CVarShadow<int> shadow{};
+    CVarBatch batch{};
+    batch.add(shadow);
+    shadow.bind(var.get());
+
+    CHECK(shadow.set(1919));
+    CHECK_EQ(var.sets, 0u);
+    CHECK_EQ(shadow.get(), 1919);
+
+    CHECK_EQ(batch.flush(), 1u);
+    CHECK_EQ(var.i, 1919);
+
+    // Same value again is free
+    CHECK(!shadow.set(1919));
+    CHECK_EQ(batch.flush(), 0u);
+    CHECK_EQ(var.sets, 1u);
+}
+
+TEST_CASE(setting_back_cancels_the_write) {
+    install();
+
+    fake::CVar var{};
+    var.i = 5;
+
+    CVarShadow<int> shadow{};
+    CVarBatch batch{};
+    batch.add(shadow);
+    shadow.bind(var.get());
+
+    CHECK(shadow.set(6));
+    CHECK(shadow.set(5));
+    CHECK_EQ(batch.flush(), 0u);
+    CHECK_EQ(var.sets, 0u);
+}
+
+TEST_CASE(enforced_shadow_corrects_outside_changes_next_flush) {
+    install();
+
+    fake::CVar var{};
+    CVarShadow<int> shadow{};
+    CVarBatch batch{};
+    batch.set_refresh_interval(0);
+    batch.add(shadow);
+    shadow.bind(var.get());
+    shadow.set_enforced(true);
+
+    shadow.set(1919);
+    batch.flush();
+
+    // The console changes it behind our back
+    var.i = 640;
+    CHECK_EQ(batch.flush(), 1u);
+    CHECK_EQ(var.i, 1919);
+    CHECK_EQ(shadow.get_stats().corrected, 1u);
+
+    // Nothing to do while it stays put
+    for (uint32_t i = 0; i < 100; ++i) {
+        CHECK_EQ(batch.flush(), 0u);
+    }
+
+    CHECK_EQ(var.sets, 2u);
+}
+
+TEST_CASE(unenforced_shadow_adopts_outside_changes_on_refresh) {
+    install();
+
+    fake::CVar var{};
+    CVarShadow<int> shadow{};
+    CVarBatch batch{};
+    batch.set_refresh_interval(2);
+    batch.add(shadow);
+    shadow.bind(var.get());
+
+    shadow.set(1919);
+    batch.flush();
+
+    var.i = 640;
+    batch.flush(); // refresh happens here, not a write
+
+    CHECK_EQ(var.i, 640);
+    CHECK_EQ(shadow.get(), 640);
+    CHECK_EQ(shadow.get_stats().corrected, 0u);
+}
+
+TEST_CASE(enforced_float_does_not_fight_rounding) {
+    install();
+
+    fake::CVar var{};
+    var.is_int = false;
+
+    CVarShadow<float> shadow{};
+    CVarBatch batch{};
+    batch.add(shadow);
+    shadow.bind(var.get());
+    shadow.set_enforced(true);
+
+    // Only 6 decimals survive the string the value is set with
+    shadow.set(0.123456789f);
+    batch.flush();
+
+    for (uint32_t i = 0; i < 10; ++i) {
+        CHECK_EQ(batch.flush(), 0u);
+    }
+
+    CHECK_EQ(var.sets, 1u);
+    CHECK_EQ(shadow.get_stats().corrected, 0u);
+}
+
+int main() {
+    return test::run_all();
+}
@@ -0,0 +1,242 @@
+#include <array>
+#include <string>
+#include <vector>
+
+#include "ConsoleIndex.hpp"
+
+#include "FakeUEVR.hpp"
+#include "Test.hpp"
+
+namespace {
+using uevr::API;
+
+// The engine's TMap<FString, IConsoleObject*> as far as ConsoleIndex reads it: the sparse array's elements
+// followed by its allocation flags, then the free list head the engine keeps
+struct FakeConsoleMap {
+    API::ConsoleObjectElement* data{nullptr};
+    int32_t count{0};
+    int32_t capacity{0};
+    ConsoleIndex::AllocationFlags flags{};
+    int32_t first_free{-1};
+    int32_t num_free{0};
+};
+
+class FakeConsole {
+public:
+    static constexpr int32_t CAPACITY = 512;
+
+    FakeConsole() {
+        m_elements.resize(CAPACITY);
+        m_names.resize(CAPACITY);
+        m_bits.resize(CAPACITY / 32);
+        m_map.data = m_elements.data();
+        m_map.capacity = CAPACITY;
+        sync();
+    }
+
+    // Reuses the most recently freed slot like TSparseArray::Add, appends otherwise
+    int32_t add(std::wstring name) {
+        int32_t slot{};
+
+        if (!m_free.empty()) {
+            slot = m_free.back();
+            m_free.pop_back();
+        } else {
+            slot = m_map.count++;
+        }
+
+        m_names[slot] = std::move(name);
+        m_elements[slot].key = m_names[slot].data();
+        m_elements[slot].value = (API::IConsoleObject*)&m_objects[m_next_object++ % m_objects.size()];
+        set_bit(slot, true);
+        sync();
+        return slot;
+    }
+
+    // Leaves a free list link where the key pointer was and the old value behind, like the engine does
+    void remove(int32_t slot) {
+        m_elements[slot].key = (wchar_t*)(uintptr_t)(0x0000000100000000ull | (uint32_t)slot);
+        set_bit(slot, false);
+        m_free.push_back(slot);
+        sync();
+    }
+
+    API::IConsoleObject* object_at(int32_t slot) const { return m_elements[slot].value; }
+    API::FConsoleManager* get() { return (API::FConsoleManager*)this; }
+    FakeConsoleMap& map() { return m_map; }
+
+private:
+    void set_bit(int32_t slot, bool value) {
+        auto& word = m_bits[slot / 32];
+        word = value ? word | (1u << (slot % 32)) : word & ~(1u << (slot % 32));
+    }
+
+    // Bit arrays up to 128 bits live inline, past that in the secondary allocation
+    void sync() {
+        m_map.flags.num_bits = m_map.count;
+        m_map.flags.max_bits = CAPACITY;
+        m_map.flags.secondary_data = m_map.count > 128 ? m_bits.data() : nullptr;
+
+        for (uint32_t i = 0; i < 4; ++i) {
+            m_map.flags.inline_data[i] = m_bits[i];
+        }
+
+        m_map.num_free = (int32_t)m_free.size();
+    }
+
+    FakeConsoleMap m_map{};
+    std::vector<API::ConsoleObjectElement> m_elements{};
+    std::vector<std::wstring> m_names{};
+    std::vector<uint32_t> m_bits{};
+    std::vector<int32_t> m_free{};
+    std::array<int, 1024> m_objects{};
+    uint32_t m_next_object{0};
+};
+
+int g_found{};
+
+void install() {
+    [[maybe_unused]] static const bool installed = [] {
+        auto& uevr = fake::get();
+        uevr.console.get_console_objects = [](UEVR_FConsoleManagerHandle mgr) {
+            return (UEVR_TArrayHandle)&((FakeConsole*)mgr)->map();
+        };
+        uevr.console.as_command = [](UEVR_IConsoleObjectHandle) { return (UEVR_IConsoleCommandHandle)nullptr; };
+        uevr.console.find_variable = [](UEVR_FConsoleManagerHandle, const wchar_t*) { return (UEVR_IConsoleVariableHandle)&g_found; };
+        uevr.install();
+        return true;
+    }();
+}
+}
+
+TEST_CASE(indexes_case_insensitively) {
+    install();
+
+    FakeConsole console{};
+    const auto width = console.add(L"r.InGameUI.FixedWidth");
+    console.add(L"r.InGameUI.FixedHeight");
+    console.add(L"r.ScreenPercentage");
+
+    ConsoleIndex index{};
+    CHECK(index.update(console.get()));
+    CHECK(!index.update(console.get()));
+
+    CHECK_EQ(index.find(L"R.INGAMEUI.FIXEDWIDTH"), console.object_at(width));
+    CHECK(index.find_variable(L"r.ingameui.fixedwidth") != nullptr);
+    CHECK(index.contains(L"r.screenpercentage"));
+    CHECK(!index.contains(L"r.InGameUI"));
+
+    const auto ui = index.find_prefix(L"R.InGameUI.");
+    CHECK_EQ(ui.size(), 2u);
+    CHECK(ui[0].name == L"r.InGameUI.FixedHeight");
+    CHECK(ui[1].name == L"r.InGameUI.FixedWidth");
+    CHECK(index.find_prefix(L"x.").empty());
+}
+
+TEST_CASE(freed_slots_are_never_read) {
+    install();
+
+    FakeConsole console{};
+    console.add(L"a.One");
+    const auto two = console.add(L"a.Two");
+    console.add(L"a.Three");
+    console.remove(two);
+
+    ConsoleIndex index{};
+    index.update(console.get());
+
+    CHECK_EQ(index.get_stats().entries, 2u);
+    CHECK(!index.contains(L"a.Two"));
+}
+
+TEST_CASE(additions_are_incremental) {
+    install();
+
+    FakeConsole console{};
+
+    for (uint32_t i = 0; i < 100; ++i) {
+        console.add(L"cvar." + std::to_wstring(i));
+    }
+
+    ConsoleIndex index{};
+    index.update(console.get());
+
+    // Appended, then past the inline bits into the secondary allocation
+    for (uint32_t i = 100; i < 200; ++i) {
+        console.add(L"cvar." + std::to_wstring(i));
+    }
+
+    CHECK(index.update(console.get()));
+    CHECK_EQ(index.get_stats().full_builds, 1u);
+    CHECK_EQ(index.get_stats().incremental_builds, 1u);
+    CHECK_EQ(index.get_stats().entries, 200u);
+    CHECK(index.contains(L"CVAR.199"));
+}
+
+TEST_CASE(refilled_slot_is_picked_up_at_the_same_count) {
+    install();
+
+    FakeConsole console{};
+    console.add(L"a.One");
+    const auto two = console.add(L"a.Two");
+    console.add(L"a.Three");
+    console.remove(two);
+
+    ConsoleIndex index{};
+    index.update(console.get());
+
+    // Same count and data pointer as before, only the hole got filled
+    const auto count = console.map().count;
+    const auto slot = console.add(L"a.Four");
+    CHECK_EQ(slot, two);
+    CHECK_EQ(console.map().count, count);
+
+    CHECK(index.update(console.get()));
+    CHECK_EQ(index.get_stats().incremental_builds, 1u);
+    CHECK_EQ(index.find(L"a.four"), console.object_at(slot));
+}
+
+TEST_CASE(removals_rebuild) {
+    install();
+
+    FakeConsole console{};
+    console.add(L"a.One");
+    const auto two = console.add(L"a.Two");
+
+    ConsoleIndex index{};
+    index.update(console.get());
+
+    console.remove(two);
+    CHECK(index.update(console.get()));
+    CHECK_EQ(index.get_stats().full_builds, 2u);
+    CHECK(!index.contains(L"a.Two"));
+
+    // Freed and refilled with a different object between two updates
+    const auto one = 0;
+    console.remove(one);
+    console.add(L"a.Other");
+    CHECK(index.update(console.get()));
+    CHECK_EQ(index.get_stats().full_builds, 3u);
+    CHECK(!index.contains(L"a.One"));
+    CHECK(index.contains(L"a.Other"));
+}
+
+TEST_CASE(unexpected_layout_is_left_alone) {
+    install();
+
+    FakeConsole console{};
+    console.add(L"a.One");
+    console.map().flags.num_bits = 7; // doesn't match the element count
+
+    ConsoleIndex index{};
+    CHECK(!index.update(console.get()));
+    CHECK_EQ(index.get_stats().bad_layouts, 1u);
+    CHECK_EQ(index.get_stats().entries, 0u);
+
+    // Variables still resolve, through the engine
+    CHECK_EQ(index.find_variable(L"a.One"), (API::IConsoleVariable*)&g_found);
+}
+
+int main() {
+    return test::run_all();
+}
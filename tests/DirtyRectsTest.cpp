@@ -0,0 +1,136 @@
+#include "DirtyRects.hpp"
+
+#include "Test.hpp"
+
+namespace {
+constexpr uint32_t TILE = 16;
+
+uint64_t cell(uint32_t x, uint32_t y) {
+    return 1ull << (y * UI_COVERAGE_GRID + x);
+}
+
+bool has_area(const ClearRect& r) {
+    return r.right > r.left && r.bottom > r.top;
+}
+
+int g_texture{};
+int g_other_texture{};
+}
+
+TEST_CASE(empty_mask_is_a_full_clear) {
+    CHECK_EQ(DirtyRects::build_rects(0, 1024, 1024, TILE, 75).count, 0u);
+}
+
+TEST_CASE(single_cell_maps_to_its_tiles) {
+    // 1024 / 16 = 64 tiles, 8 per cell
+    const auto rects = DirtyRects::build_rects(cell(2, 3), 1024, 1024, TILE, 75);
+
+    CHECK_EQ(rects.count, 1u);
+    CHECK_EQ(rects.rects[0].left, 256);
+    CHECK_EQ(rects.rects[0].right, 384);
+    CHECK_EQ(rects.rects[0].top, 384);
+    CHECK_EQ(rects.rects[0].bottom, 512);
+}
+
+TEST_CASE(identical_runs_merge_downwards) {
+    const auto mask = cell(1, 1) | cell(2, 1) | cell(1, 2) | cell(2, 2) | cell(6, 6);
+    const auto rects = DirtyRects::build_rects(mask, 1024, 1024, TILE, 75);
+
+    CHECK_EQ(rects.count, 2u);
+    CHECK_EQ(rects.rects[0].left, 128);
+    CHECK_EQ(rects.rects[0].right, 384);
+    CHECK_EQ(rects.rects[0].top, 128);
+    CHECK_EQ(rects.rects[0].bottom, 384);
+}
+
+TEST_CASE(mostly_covered_is_a_full_clear) {
+    CHECK_EQ(DirtyRects::build_rects(~0ull, 1024, 1024, TILE, 75).count, 0u);
+    CHECK_EQ(DirtyRects::build_rects(0x00000000FFFFFFFFull, 1024, 1024, TILE, 75).count, 1u);
+    CHECK_EQ(DirtyRects::build_rects(0x00000000FFFFFFFFull, 1024, 1024, TILE, 40).count, 0u);
+}
+
+TEST_CASE(small_target_has_no_zero_area_rects) {
+    // 64x48 is 4x3 tiles, so most grid cells don't own any pixels
+    for (uint32_t y = 0; y < UI_COVERAGE_GRID; ++y) {
+        for (uint32_t x = 0; x < UI_COVERAGE_GRID; ++x) {
+            const auto rects = DirtyRects::build_rects(cell(x, y), 64, 48, TILE, 100);
+
+            for (uint32_t i = 0; i < rects.count; ++i) {
+                CHECK(has_area(rects.rects[i]));
+                CHECK(rects.rects[i].right <= 64);
+                CHECK(rects.rects[i].bottom <= 48);
+            }
+        }
+    }
+
+    // Cell 1 doesn't own a tile on either axis, which leaves nothing to clear by rect
+    CHECK_EQ(DirtyRects::build_rects(cell(1, 1), 64, 48, TILE, 100).count, 0u);
+    CHECK_EQ(DirtyRects::build_rects(cell(0, 0) | cell(1, 1), 64, 48, TILE, 100).count, 1u);
+}
+
+TEST_CASE(dilate_stays_inside_the_grid) {
+    CHECK_EQ(DirtyRects::dilate(cell(0, 0)), cell(0, 0) | cell(1, 0) | cell(0, 1) | cell(1, 1));
+    CHECK_EQ(DirtyRects::dilate(cell(7, 0)), cell(7, 0) | cell(6, 0) | cell(7, 1) | cell(6, 1));
+    CHECK_EQ(DirtyRects::dilate(cell(7, 7)), cell(7, 7) | cell(6, 7) | cell(7, 6) | cell(6, 6));
+}
+
+TEST_CASE(trusted_only_once_stable) {
+    DirtyRects dirty{};
+    dirty.set_config({4, 75});
+
+    uint64_t frame = 0;
+    dirty.add(&g_texture, cell(3, 3), ++frame);
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        dirty.add(&g_texture, cell(3, 3), ++frame);
+    }
+
+    CHECK(!dirty.is_trusted(&g_texture));
+    CHECK_EQ(dirty.build(&g_texture, 1024, 1024, TILE).count, 0u);
+
+    dirty.add(&g_texture, 0, ++frame);
+    CHECK(dirty.is_trusted(&g_texture));
+    CHECK(!dirty.is_trusted(&g_other_texture));
+    CHECK(!dirty.is_empty(&g_texture));
+    CHECK(dirty.build(&g_texture, 1024, 1024, TILE).count > 0);
+
+    // Growing coverage starts the count over
+    dirty.add(&g_texture, cell(0, 0), ++frame);
+    CHECK(!dirty.is_trusted(&g_texture));
+
+    // So does a different texture
+    dirty.add(&g_other_texture, 0, ++frame);
+    CHECK_EQ(dirty.get_samples(), 1u);
+}
+
+TEST_CASE(empty_needs_a_trusted_zero_mask) {
+    DirtyRects dirty{};
+    dirty.set_config({2, 75});
+
+    dirty.add(&g_texture, 0, 1);
+    dirty.add(&g_texture, 0, 2);
+    CHECK(!dirty.is_empty(&g_texture));
+
+    dirty.add(&g_texture, 0, 3);
+    CHECK(dirty.is_empty(&g_texture));
+    CHECK(!dirty.is_empty(nullptr));
+}
+
+TEST_CASE(remembers_the_newest_probed_frame) {
+    DirtyRects dirty{};
+
+    dirty.add(&g_texture, 0, 7);
+    dirty.add(&g_texture, 0, 9);
+    dirty.add(&g_texture, 0, 8); // results landing out of order don't move it back
+    CHECK_EQ(dirty.get_frame(), 9u);
+
+    dirty.add(&g_other_texture, 0, 10);
+    CHECK_EQ(dirty.get_frame(), 10u);
+
+    dirty.reset();
+    CHECK_EQ(dirty.get_frame(), 0u);
+}
+
+int main() {
+    return test::run_all();
+}
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "FakeUEVR.hpp"
+
+// Calls through API.hpp's dispatch table against the lazy function local statics the wrappers used before,
+// with the SDK functions faked so only the cost of getting to the function pointer differs.
+// Numbers only mean something in an optimized build:
+// > cmake -S tests -B build-tests -DCMAKE_BUILD_TYPE=Release
+// > cmake --build build-tests --target DispatchBenchmark && build-tests/DispatchBenchmark
+namespace {
+using uevr::API;
+
+// UObject's wrappers as they were, initialize() on first use and a static guard on every call
+namespace baseline {
+struct UObject {
+    inline UEVR_UObjectHandle to_handle() const { return (UEVR_UObjectHandle)this; }
+
+    inline API::UClass* get_class() const {
+        static const auto fn = initialize()->get_class;
+        return (API::UClass*)fn(to_handle());
+    }
+
+    inline UObject* get_outer() const {
+        static const auto fn = initialize()->get_outer;
+        return (UObject*)fn(to_handle());
+    }
+
+    inline bool is_a(API::UClass* cmp) const {
+        static const auto fn = initialize()->is_a;
+        return fn(to_handle(), (UEVR_UClassHandle)cmp);
+    }
+
+    API::FName* get_fname() const {
+        static const auto fn = initialize()->get_fname;
+        return (API::FName*)fn(to_handle());
+    }
+
+private:
+    static inline const UEVR_UObjectFunctions* s_functions{nullptr};
+    inline static const UEVR_UObjectFunctions* initialize() {
+        if (s_functions == nullptr) {
+            s_functions = API::get()->sdk()->uobject;
+        }
+
+        return s_functions;
+    }
+};
+}
+
+struct FakeObject {
+    FakeObject* outer{nullptr};
+    uintptr_t klass{0x1000};
+    uintptr_t name{0x2000};
+};
+
+void install() {
+    auto& uevr = fake::get();
+    uevr.uobject.get_class = [](UEVR_UObjectHandle obj) { return (UEVR_UClassHandle)((FakeObject*)obj)->klass; };
+    uevr.uobject.get_outer = [](UEVR_UObjectHandle obj) { return (UEVR_UObjectHandle)((FakeObject*)obj)->outer; };
+    uevr.uobject.is_a = [](UEVR_UObjectHandle obj, UEVR_UClassHandle cmp) { return ((FakeObject*)obj)->klass == (uintptr_t)cmp; };
+    uevr.uobject.get_fname = [](UEVR_UObjectHandle obj) { return (UEVR_FNameHandle) & ((FakeObject*)obj)->name; };
+    uevr.install();
+}
+
+// What a plugin does with an object most of the time, four different wrappers back to back
+template <typename T>
+uintptr_t touch(const T* obj) {
+    auto out = (uintptr_t)obj->get_class();
+    out += (uintptr_t)obj->get_outer();
+    out += obj->is_a((API::UClass*)0x1000) ? 1 : 0;
+    out += (uintptr_t)obj->get_fname();
+    return out;
+}
+
+// Enough to push the statics, the dispatch table and the SDK's tables out of every cache level.
+// Kept off the globals, its bookkeeping would otherwise warm whatever shares a cache line with it.
+void evict(uint8_t* buffer, size_t size) {
+    for (size_t i = 0; i < size; i += 64) {
+        buffer[i] += 1;
+    }
+}
+
+template <typename F>
+double best_ns(uint32_t runs, uint64_t calls, F&& fn) {
+    auto best = 1e30;
+
+    for (uint32_t i = 0; i < runs; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = (std::min)(best, elapsed / (double)calls);
+    }
+
+    return best;
+}
+
+volatile uintptr_t g_sink{0};
+
+double median(std::vector<double>& times) {
+    std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+    return times[times.size() / 2];
+}
+}
+
+int main() {
+    install();
+
+    FakeObject outer{};
+    FakeObject object{&outer};
+    const auto as_api = (const API::UObject*)&object;
+    const auto as_baseline = (const baseline::UObject*)&object;
+
+    // Gets the lazy statics initialized before anything is timed
+    g_sink = touch(as_baseline) + touch(as_api);
+
+    constexpr uint64_t HOT = 50'000'000;
+
+    const auto hot_baseline = best_ns(5, HOT * 4, [&] {
+        uintptr_t sum = 0;
+        for (uint64_t i = 0; i < HOT; ++i) sum += touch(as_baseline);
+        g_sink = sum;
+    });
+
+    const auto hot_dispatch = best_ns(5, HOT * 4, [&] {
+        uintptr_t sum = 0;
+        for (uint64_t i = 0; i < HOT; ++i) sum += touch(as_api);
+        g_sink = sum;
+    });
+
+    // Cold: the caches are flushed before every group of four calls and only the calls are timed.
+    // Both sides take turns so drift on the machine hits them the same.
+    std::vector<uint8_t> buffer(64 * 1024 * 1024);
+    std::vector<double> cold[3]{};
+
+    for (uint32_t i = 0; i < 3 * 501; ++i) {
+        evict(buffer.data(), buffer.size());
+
+        const auto start = std::chrono::steady_clock::now();
+
+        switch (i % 3) {
+        case 0: g_sink = touch(as_baseline); break;
+        case 1: g_sink = touch(as_api); break;
+        default: break;
+        }
+
+        cold[i % 3].push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    const auto cold_empty = median(cold[2]);
+    const auto cold_baseline = median(cold[0]) - cold_empty;
+    const auto cold_dispatch = median(cold[1]) - cold_empty;
+
+    std::printf("hot, per call:               baseline %6.2fns  dispatch %6.2fns\n", hot_baseline, hot_dispatch);
+    std::printf("cold, median per 4 calls:    baseline %6.1fns  dispatch %6.1fns\n", cold_baseline, cold_dispatch);
+    return 0;
+}
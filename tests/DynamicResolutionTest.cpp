@@ -0,0 +1,113 @@
+#include <vector>
+
+#include "DynamicResolution.hpp"
+
+#include "Test.hpp"
+
+namespace {
+constexpr float HZ_90 = 1000.0f / 90.0f;
+constexpr uint32_t EYE_W = 2016;
+constexpr uint32_t EYE_H = 2240;
+
+DynamicResolution::Config enabled_config() {
+    DynamicResolution::Config config{};
+    config.enabled = true;
+    config.controller.target_ms = HZ_90;
+    return config;
+}
+
+// Every size the trace produces, one per scale change
+std::vector<DynamicResolution::Size> replay(DynamicResolution& dr, const std::vector<float>& trace) {
+    std::vector<DynamicResolution::Size> sizes{};
+
+    for (const auto ms : trace) {
+        if (dr.add_sample(ms)) {
+            sizes.push_back(dr.compute(EYE_W, EYE_H));
+        }
+    }
+
+    return sizes;
+}
+
+// Heavy load, then the load goes away
+std::vector<float> load_then_idle() {
+    std::vector<float> trace{};
+
+    for (uint32_t i = 0; i < 45 * 40; ++i) {
+        trace.push_back(HZ_90 * (1.4f + (float)(i % 7) * 0.01f));
+    }
+
+    for (uint32_t i = 0; i < 45 * 200; ++i) {
+        trace.push_back(HZ_90 * (0.99f - (float)(i % 5) * 0.001f));
+    }
+
+    return trace;
+}
+}
+
+TEST_CASE(disabled_does_nothing) {
+    DynamicResolution dr{};
+
+    for (uint32_t i = 0; i < 10000; ++i) {
+        CHECK(!dr.add_sample(HZ_90 * 2.0f));
+    }
+
+    CHECK_EQ(dr.get_scale(), 1.0f);
+    CHECK(dr.compute(EYE_W, EYE_H) == (DynamicResolution::Size{EYE_W * 2, EYE_H}));
+}
+
+TEST_CASE(sizes_are_quantized_per_eye) {
+    const auto size = DynamicResolution::compute(2016, 2240, 0.83f, 8);
+    CHECK_EQ(size.width % 16, 0u);
+    CHECK_EQ(size.height % 8, 0u);
+    CHECK_EQ(size.width, 1672u * 2);
+    CHECK_EQ(size.height, 1856u);
+
+    CHECK(DynamicResolution::compute(2016, 2240, 1.0f, 8) == (DynamicResolution::Size{4032, 2240}));
+    CHECK(DynamicResolution::compute(0, 2240, 0.5f, 8) == DynamicResolution::Size{});
+    CHECK(DynamicResolution::compute(2016, 2240, 0.001f, 8) == (DynamicResolution::Size{16, 8}));
+    CHECK(DynamicResolution::compute(2016, 2240, 0.5f, 0) == (DynamicResolution::Size{2016, 1120}));
+}
+
+TEST_CASE(trace_stays_within_bounds_and_recovers) {
+    DynamicResolution dr{};
+    auto config = enabled_config();
+    config.min_scale = 0.75f;
+    dr.set_config(config);
+
+    const auto sizes = replay(dr, load_then_idle());
+    CHECK(!sizes.empty());
+
+    const auto min_size = DynamicResolution::compute(EYE_W, EYE_H, 0.75f, config.granularity);
+    bool reached_min = false;
+
+    for (const auto& size : sizes) {
+        CHECK(size.width >= min_size.width && size.width <= EYE_W * 2);
+        CHECK(size.height >= min_size.height && size.height <= EYE_H);
+        CHECK_EQ((size.width / 2) % config.granularity, 0u);
+        reached_min |= size == min_size;
+    }
+
+    CHECK(reached_min);
+    CHECK_EQ(dr.get_scale(), 1.0f);
+    CHECK(sizes.back() == (DynamicResolution::Size{EYE_W * 2, EYE_H}));
+}
+
+TEST_CASE(replay_is_deterministic) {
+    DynamicResolution a{};
+    DynamicResolution b{};
+    a.set_config(enabled_config());
+    b.set_config(enabled_config());
+
+    const auto trace = load_then_idle();
+    CHECK(replay(a, trace) == replay(b, trace));
+
+    // reset() starts the same trace over from scratch
+    a.reset();
+    b.set_config(enabled_config());
+    CHECK(replay(a, trace) == replay(b, trace));
+}
+
+int main() {
+    return test::run_all();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cwchar>
+#include <string>
+
+#include "uevr/API.hpp"
+
+// Just enough of a UEVR_PluginInitializeParam for API::initialize, every table a test doesn't
+// fill in stays zeroed. Tests fill in the functions they need, then call install() once.
+namespace fake {
+struct UEVR {
+    UEVR_PluginFunctions plugin{};
+    UEVR_SDKFunctions functions{};
+    UEVR_UObjectFunctions uobject{};
+    UEVR_UObjectArrayFunctions uobject_array{};
+    UEVR_UObjectHookFunctions uobject_hook{};
+    UEVR_FNameFunctions fname{};
+    UEVR_ConsoleFunctions console{};
+    UEVR_FRenderTargetPoolHookFunctions render_target_pool_hook{};
+    UEVR_SDKData sdk{};
+    UEVR_PluginInitializeParam param{};
+
+    void install() {
+        sdk.functions = &functions;
+        sdk.uobject = &uobject;
+        sdk.uobject_array = &uobject_array;
+        sdk.uobject_hook = &uobject_hook;
+        sdk.fname = &fname;
+        sdk.console = &console;
+        sdk.render_target_pool_hook = &render_target_pool_hook;
+        param.functions = &plugin;
+        param.sdk = &sdk;
+
+        uevr::API::initialize(&param);
+    }
+};
+
+inline UEVR& get() {
+    static UEVR instance{};
+    return instance;
+}
+
+// A console variable that parses what it's set to the way the engine's int and float cvars do
+struct CVar {
+    bool is_int{true};
+    bool is_string{false}; // reads back as 0 whatever it's set to
+    int i{0};
+    float f{0.0f};
+    uint32_t sets{0};
+
+    uevr::API::IConsoleVariable* get() { return (uevr::API::IConsoleVariable*)this; }
+
+    static void install(UEVR_ConsoleFunctions& console) {
+        console.variable_set = [](UEVR_IConsoleVariableHandle handle, const wchar_t* value) {
+            auto var = (CVar*)handle;
+            ++var->sets;
+
+            if (var->is_string) {
+                return;
+            }
+
+            if (var->is_int) {
+                var->i = (int)std::wcstol(value, nullptr, 10);
+            } else {
+                var->f = std::wcstof(value, nullptr);
+            }
+        };
+
+        console.variable_get_int = [](UEVR_IConsoleVariableHandle handle) {
+            const auto var = (CVar*)handle;
+            return var->is_int ? var->i : (int)var->f;
+        };
+
+        console.variable_get_float = [](UEVR_IConsoleVariableHandle handle) {
+            const auto var = (CVar*)handle;
+            return var->is_int ? (float)var->i : var->f;
+        };
+    }
+};
+}
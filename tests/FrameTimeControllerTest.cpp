@@ -0,0 +1,138 @@
+#include <cmath>
+
+#include "FrameTimeController.hpp"
+
+#include "Test.hpp"
+
+namespace {
+constexpr float HZ_90 = 1000.0f / 90.0f;
+constexpr float HZ_72 = 1000.0f / 72.0f;
+
+// Replays windows worth of the same interval, returns how many times the scale changed
+uint32_t replay(FrameTimeController& controller, float ms, uint32_t windows) {
+    uint32_t changes = 0;
+
+    for (uint32_t i = 0; i < windows * controller.get_config().window; ++i) {
+        changes += controller.add_sample(ms) ? 1 : 0;
+    }
+
+    return changes;
+}
+
+// 90% of the frames reprojected at twice the period, the rest on time
+void replay_reprojected(FrameTimeController& controller, float period, uint32_t windows) {
+    for (uint32_t i = 0; i < windows * controller.get_config().window; ++i) {
+        controller.add_sample(i % 10 == 0 ? period : period * 2.0f);
+    }
+}
+
+bool near(float a, float b) {
+    return std::abs(a - b) < 0.001f;
+}
+
+FrameTimeController::Config fixed_target(float target_ms) {
+    FrameTimeController::Config config{};
+    config.target_ms = target_ms;
+    return config;
+}
+}
+
+TEST_CASE(detects_the_refresh_rate) {
+    FrameTimeController controller{};
+
+    replay(controller, HZ_90, 1);
+    CHECK(near(controller.get_target_ms(), HZ_90));
+
+    // Reprojection at half rate still reads as the headset's own period
+    replay_reprojected(controller, HZ_90, 4);
+    CHECK(near(controller.get_target_ms(), HZ_90));
+    CHECK_EQ(controller.get_stats().refresh_changes, 0u);
+}
+
+TEST_CASE(follows_refresh_rate_changes_both_ways) {
+    FrameTimeController controller{};
+
+    replay(controller, HZ_90, 2);
+    CHECK(near(controller.get_target_ms(), HZ_90));
+
+    // Headset switched to 72Hz, the slower period has to hold for a while first
+    replay(controller, HZ_72, controller.get_config().detect_windows - 1);
+    CHECK(near(controller.get_target_ms(), HZ_90));
+
+    replay(controller, HZ_72, 1);
+    CHECK(near(controller.get_target_ms(), HZ_72));
+
+    // And back up
+    replay(controller, HZ_90, controller.get_config().detect_windows);
+    CHECK(near(controller.get_target_ms(), HZ_90));
+    CHECK_EQ(controller.get_stats().refresh_changes, 2u);
+}
+
+TEST_CASE(odd_windows_dont_move_the_target) {
+    FrameTimeController controller{};
+
+    replay(controller, HZ_90, 2);
+
+    for (uint32_t i = 0; i < 10; ++i) {
+        replay(controller, HZ_72, 1);
+        replay(controller, HZ_90, 1);
+    }
+
+    CHECK(near(controller.get_target_ms(), HZ_90));
+    CHECK_EQ(controller.get_stats().refresh_changes, 0u);
+}
+
+TEST_CASE(steps_down_to_the_minimum_when_over_budget) {
+    FrameTimeController controller{fixed_target(HZ_90)};
+
+    // Every decision is followed by cooldown_windows ignored windows
+    const auto per_step = 1 + controller.get_config().cooldown_windows;
+    replay(controller, HZ_90 * 1.5f, per_step * 20);
+
+    CHECK(near(controller.get_scale(), controller.get_config().min_scale));
+    CHECK_EQ(controller.get_stats().decreases, 10u);
+}
+
+TEST_CASE(recovers_once_back_on_budget) {
+    FrameTimeController controller{fixed_target(HZ_90)};
+
+    replay(controller, HZ_90 * 1.5f, 3);
+    CHECK(controller.get_scale() < 1.0f);
+
+    replay(controller, HZ_90, 2 + controller.get_windows_to_increase());
+    CHECK(near(controller.get_scale(), 1.0f));
+    CHECK_EQ(controller.get_stats().increases, 1u);
+}
+
+TEST_CASE(failed_increases_back_off) {
+    FrameTimeController controller{fixed_target(HZ_90)};
+
+    replay(controller, HZ_90 * 1.5f, 1);
+    replay(controller, HZ_90, 2); // cooldown
+
+    const auto windows_before = controller.get_windows_to_increase();
+    replay(controller, HZ_90, windows_before);
+    CHECK_EQ(controller.get_stats().increases, 1u);
+
+    // Going back up made it miss the budget again, the next try waits twice as long
+    replay(controller, HZ_90 * 1.5f, 3);
+    CHECK_EQ(controller.get_stats().failed_increases, 1u);
+    CHECK_EQ(controller.get_windows_to_increase(), windows_before * 2);
+}
+
+TEST_CASE(hitches_are_ignored) {
+    FrameTimeController controller{fixed_target(HZ_90)};
+
+    for (uint32_t i = 0; i < 1000; ++i) {
+        controller.add_sample(500.0f);
+        controller.add_sample(0.0f);
+        controller.add_sample(NAN);
+    }
+
+    CHECK_EQ(controller.get_stats().samples, 0u);
+    CHECK(near(controller.get_scale(), 1.0f));
+}
+
+int main() {
+    return test::run_all();
+}
@@ -0,0 +1,146 @@
+#include <array>
+
+#include "GpuProfiler.hpp"
+
+#include "Test.hpp"
+
+namespace {
+// Timestamps are whatever the test writes into ticks, a slot only reads back once the test marks it done
+struct FakeQueries {
+    using Context = int;
+
+    struct Slot {
+        std::array<uint64_t, GPU_PROFILER_MAX_TIMESTAMPS> written{};
+        bool submitted{false};
+        bool done{false};
+    };
+
+    bool begin_frame(uint32_t slot) {
+        slots[slot] = {};
+        return true;
+    }
+
+    void timestamp(uint32_t slot, uint32_t index, Context) {
+        slots[slot].written[index] = ticks;
+        ticks += tick_step;
+    }
+
+    bool end_frame(uint32_t slot, uint32_t count) {
+        slots[slot].submitted = submit && count > 0;
+        return slots[slot].submitted;
+    }
+
+    bool read(uint32_t slot, uint32_t count, uint64_t* out, uint64_t& freq) {
+        if (!slots[slot].submitted || !slots[slot].done) {
+            return false;
+        }
+
+        for (uint32_t i = 0; i < count; ++i) {
+            out[i] = slots[slot].written[i];
+        }
+
+        freq = frequency;
+        return true;
+    }
+
+    void complete_all() {
+        for (auto& s : slots) {
+            s.done = true;
+        }
+    }
+
+    std::array<Slot, GPU_PROFILER_FRAMES> slots{};
+    uint64_t ticks{1000};
+    uint64_t tick_step{5000};
+    uint64_t frequency{1'000'000'000}; // 1 tick = 1ns
+    bool submit{true};
+};
+
+using Profiler = GpuProfiler<FakeQueries>;
+
+void profile_frame(Profiler& profiler, GpuOp op) {
+    profiler.begin_frame();
+    {
+        Profiler::Scope _{profiler, op, 0};
+    }
+    profiler.end_frame();
+}
+}
+
+TEST_CASE(resolves_once_the_gpu_is_done) {
+    Profiler profiler{};
+
+    profile_frame(profiler, GpuOp::ClearUI);
+    profiler.collect();
+
+    CHECK_EQ(profiler.get_timings()[(size_t)GpuOp::ClearUI].frame, 0u);
+    CHECK_EQ(profiler.num_resolved_frames(), 0u);
+
+    profiler.get_queries().complete_all();
+    profiler.collect();
+
+    const auto& timing = profiler.get_timings()[(size_t)GpuOp::ClearUI];
+    CHECK_EQ(timing.frame, 1u);
+    CHECK_EQ(timing.gpu_us, 5.0f);
+    CHECK(timing.cpu_us >= 0.0f);
+    CHECK_EQ(profiler.num_resolved_frames(), 1u);
+}
+
+TEST_CASE(skips_frames_instead_of_waiting) {
+    Profiler profiler{};
+
+    // Every slot still in flight, the next frame that lands on one has to be skipped
+    for (uint32_t i = 0; i < Profiler::NUM_FRAMES; ++i) {
+        profile_frame(profiler, GpuOp::SnapshotUI);
+    }
+
+    profile_frame(profiler, GpuOp::SnapshotUI);
+    CHECK_EQ(profiler.num_skipped_frames(), 1u);
+
+    profiler.get_queries().complete_all();
+    profile_frame(profiler, GpuOp::SnapshotUI);
+
+    CHECK_EQ(profiler.num_skipped_frames(), 1u);
+    CHECK_EQ(profiler.num_resolved_frames(), Profiler::NUM_FRAMES);
+}
+
+TEST_CASE(unsubmitted_slot_is_never_read) {
+    Profiler profiler{};
+
+    profiler.get_queries().submit = false;
+    profile_frame(profiler, GpuOp::ProbeUI);
+    profiler.get_queries().complete_all();
+    profiler.collect();
+
+    // Nothing reported, and the slot isn't left pending forever either
+    CHECK_EQ(profiler.get_timings()[(size_t)GpuOp::ProbeUI].frame, 0u);
+    CHECK_EQ(profiler.num_resolved_frames(), 0u);
+
+    for (uint32_t i = 0; i < Profiler::NUM_FRAMES * 2; ++i) {
+        profile_frame(profiler, GpuOp::ProbeUI);
+    }
+
+    CHECK_EQ(profiler.num_skipped_frames(), 0u);
+}
+
+TEST_CASE(disjoint_frame_frees_the_slot) {
+    Profiler profiler{};
+
+    profiler.get_queries().frequency = 0;
+    profile_frame(profiler, GpuOp::ClearUI);
+    profiler.get_queries().complete_all();
+    profiler.collect();
+
+    CHECK_EQ(profiler.get_timings()[(size_t)GpuOp::ClearUI].frame, 0u);
+
+    profiler.get_queries().frequency = 1'000'000'000;
+    profile_frame(profiler, GpuOp::ClearUI);
+    profiler.get_queries().complete_all();
+    profiler.collect();
+
+    CHECK_EQ(profiler.get_timings()[(size_t)GpuOp::ClearUI].frame, 2u);
+}
+
+int main() {
+    return test::run_all();
+}
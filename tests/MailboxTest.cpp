@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "Mailbox.hpp"
+
+#include "Test.hpp"
+
+namespace {
+struct Item {
+    uint64_t sequence{0};
+    uint64_t check{0}; // always ~sequence, a torn read would break that
+    std::chrono::steady_clock::time_point published{};
+};
+}
+
+TEST_CASE(empty_until_pushed) {
+    Mailbox<Item> mailbox{};
+
+    CHECK(mailbox.empty());
+    CHECK(!mailbox.pop());
+
+    mailbox.push(Item{1, ~1ull});
+
+    CHECK(!mailbox.empty());
+
+    const auto item = mailbox.pop();
+    CHECK(item && item->sequence == 1);
+    CHECK(mailbox.empty());
+    CHECK(!mailbox.pop());
+}
+
+TEST_CASE(latest_push_wins) {
+    Mailbox<Item> mailbox{};
+
+    for (uint64_t i = 1; i <= 5; ++i) {
+        mailbox.push(Item{i, ~i});
+    }
+
+    const auto item = mailbox.pop();
+    CHECK(item && item->sequence == 5);
+    CHECK_EQ(mailbox.num_replaced(), 4u);
+    CHECK(!mailbox.pop());
+
+    // Slots keep rotating correctly after the consumer has taken one
+    mailbox.push(Item{6, ~6ull});
+    mailbox.push(Item{7, ~7ull});
+    CHECK_EQ(mailbox.pop()->sequence, 7u);
+    mailbox.push(Item{8, ~8ull});
+    CHECK_EQ(mailbox.pop()->sequence, 8u);
+}
+
+// A render thread pushing as fast as it can against a present thread that stalls now and then,
+// which is when the old ring dropped the newest item
+TEST_CASE(stress_producer_consumer) {
+    constexpr uint64_t count = 2'000'000;
+
+    Mailbox<Item> mailbox{};
+    std::atomic<bool> done{false};
+
+    uint64_t received{0};
+    uint64_t last{0};
+    bool ordered{true};
+    bool intact{true};
+    std::vector<int64_t> latencies_ns{};
+    latencies_ns.reserve(count);
+
+    std::thread consumer{[&]() {
+        uint32_t spins{0};
+
+        while (true) {
+            const auto finished = done.load(std::memory_order_acquire);
+
+            if (const auto item = mailbox.pop(); item) {
+                const auto now = std::chrono::steady_clock::now();
+                latencies_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - item->published).count());
+                ordered &= item->sequence > last;
+                intact &= item->check == ~item->sequence;
+                last = item->sequence;
+                ++received;
+
+                if (++spins % 64 == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds{50});
+                }
+            } else if (finished) {
+                break;
+            }
+        }
+    }};
+
+    for (uint64_t i = 1; i <= count; ++i) {
+        mailbox.push(Item{i, ~i, std::chrono::steady_clock::now()});
+    }
+
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    CHECK(ordered);
+    CHECK(intact);
+    CHECK_EQ(last, count); // the newest item always gets through
+    CHECK_EQ(received + mailbox.num_replaced(), count);
+
+    std::sort(latencies_ns.begin(), latencies_ns.end());
+
+    if (!latencies_ns.empty()) {
+        std::printf("  %llu received, %u replaced, latency p50 %.2fus p99 %.2fus max %.2fus\n",
+            (unsigned long long)received, mailbox.num_replaced(),
+            (double)latencies_ns[latencies_ns.size() / 2] / 1000.0,
+            (double)latencies_ns[latencies_ns.size() * 99 / 100] / 1000.0,
+            (double)latencies_ns.back() / 1000.0);
+    }
+}
+
+int main() {
+    return test::run_all();
+}
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <vector>
+
+#include "FakeUEVR.hpp"
+#include "Test.hpp"
+
+namespace {
+using uevr::API;
+
+int g_class{};
+int g_objects[256]{};
+uint32_t g_matches{0};
+bool g_returns_total{false}; // whether a walk into a buffer reports the full count or only what it wrote
+uint32_t g_walks{0};
+uint32_t g_counts{0};
+
+void install() {
+    [[maybe_unused]] static const bool installed = [] {
+        auto& uevr = fake::get();
+        uevr.uobject_hook.activate = [] {};
+        uevr.uobject_hook.get_objects_by_class = [](UEVR_UClassHandle, UEVR_UObjectHandle* out, unsigned int max, bool) {
+            if (out == nullptr || max == 0) {
+                ++g_counts;
+                return (int)g_matches;
+            }
+
+            ++g_walks;
+            const auto written = (std::min)(g_matches, max);
+
+            for (uint32_t i = 0; i < written; ++i) {
+                out[i] = (UEVR_UObjectHandle)&g_objects[i];
+            }
+
+            return (int)(g_returns_total ? g_matches : written);
+        };
+        uevr.install();
+        return true;
+    }();
+}
+
+API::UClass* klass() {
+    return (API::UClass*)&g_class;
+}
+
+void setup(uint32_t matches, bool returns_total = false) {
+    install();
+    g_matches = matches;
+    g_returns_total = returns_total;
+    g_walks = 0;
+    g_counts = 0;
+}
+
+bool is_prefix(const std::vector<API::UObject*>& objects) {
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (objects[i] != (API::UObject*)&g_objects[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+}
+
+TEST_CASE(first_call_is_one_walk) {
+    setup(10);
+    std::vector<API::UObject*> objects{};
+
+    klass()->get_objects_matching(objects);
+    CHECK_EQ(objects.size(), 10u);
+    CHECK(is_prefix(objects));
+    CHECK_EQ(g_walks, 1u);
+    CHECK_EQ(g_counts, 0u);
+    CHECK(objects.capacity() >= 64u);
+}
+
+TEST_CASE(exact_fill_asks_the_count_once) {
+    setup(64);
+    std::vector<API::UObject*> objects{};
+
+    klass()->get_objects_matching(objects);
+    CHECK_EQ(objects.size(), 64u);
+    CHECK(is_prefix(objects));
+    CHECK_EQ(g_walks, 1u);
+    CHECK_EQ(g_counts, 1u);
+
+    // The buffer got room to spare, the same result fits without the count now
+    klass()->get_objects_matching(objects);
+    CHECK_EQ(objects.size(), 64u);
+    CHECK_EQ(g_walks, 2u);
+    CHECK_EQ(g_counts, 1u);
+}
+
+TEST_CASE(more_than_fits_grows_once) {
+    setup(100);
+    std::vector<API::UObject*> objects{};
+
+    klass()->get_objects_matching(objects);
+    CHECK_EQ(objects.size(), 100u);
+    CHECK(is_prefix(objects));
+    CHECK_EQ(g_walks, 2u);
+    CHECK_EQ(g_counts, 1u);
+
+    klass()->get_objects_matching(objects);
+    CHECK_EQ(objects.size(), 100u);
+    CHECK_EQ(g_walks, 3u);
+    CHECK_EQ(g_counts, 1u);
+
+    // Fewer than last time still fits
+    g_matches = 20;
+    klass()->get_objects_matching(objects);
+    CHECK_EQ(objects.size(), 20u);
+    CHECK_EQ(g_walks, 4u);
+}
+
+TEST_CASE(reported_total_skips_the_count) {
+    setup(100, true);
+    std::vector<API::UObject*> objects{};
+
+    klass()->get_objects_matching(objects);
+    CHECK_EQ(objects.size(), 100u);
+    CHECK(is_prefix(objects));
+    CHECK_EQ(g_walks, 2u);
+    CHECK_EQ(g_counts, 0u);
+}
+
+TEST_CASE(no_matches) {
+    setup(0);
+    std::vector<API::UObject*> objects{};
+
+    klass()->get_objects_matching(objects);
+    CHECK(objects.empty());
+    CHECK_EQ(g_walks, 1u);
+    CHECK_EQ(g_counts, 0u);
+}
+
+int main() {
+    return test::run_all();
+}
@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "PluginConfig.hpp"
+#include "Readback.hpp"
+
+#include "Test.hpp"
+
+namespace {
+std::filesystem::path write_config(const char* contents) {
+    const auto path = std::filesystem::temp_directory_path() / "ff7plugin_test.txt";
+    std::ofstream{path} << contents;
+    return path;
+}
+}
+
+TEST_CASE(reads_keys_and_falls_back_to_defaults) {
+    const auto path = write_config(
+        "# comment\n"
+        "UI_Snapshots = true\r\n"
+        "Stats_Log_Frames=450\n"
+        "Min_Scale=0.75\n"
+        "Broken=12abc\n"
+        "no equals sign\n"
+        "; other comment\n");
+
+    const auto config = PluginConfig::load(path);
+    std::filesystem::remove(path);
+
+    CHECK_EQ(config.size(), 4u);
+    CHECK(config.get_bool("UI_Snapshots", false));
+    CHECK(!config.get_bool("UI_Probe", false));
+    CHECK_EQ(config.get_number<uint32_t>("Stats_Log_Frames", 900), 450u);
+    CHECK_EQ(config.get_number<float>("Min_Scale", 1.0f), 0.75f);
+    CHECK_EQ(config.get_number<int32_t>("Broken", 7), 7);
+    CHECK_EQ(config.get_number<int32_t>("Missing", 3), 3);
+}
+
+TEST_CASE(missing_file_is_empty) {
+    const auto config = PluginConfig::load("does/not/exist.txt");
+
+    CHECK_EQ(config.size(), 0u);
+    CHECK(config.get_bool("UI_Snapshots", true));
+}
+
+TEST_CASE(alpha_coverage_respects_row_pitch) {
+    constexpr uint32_t width = 8;
+    constexpr uint32_t height = 4;
+    constexpr uint32_t pitch = 64; // padded past width * 4
+
+    std::vector<uint8_t> data(pitch * height, 0xCC); // padding must never be read as pixels
+
+    for (uint32_t y = 0; y < height; ++y) {
+        auto row = (uint32_t*)(data.data() + y * pitch);
+
+        for (uint32_t x = 0; x < width; ++x) {
+            row[x] = x < 2 ? 0xFF000000 : 0x00FFFFFF;
+        }
+    }
+
+    ReadbackView view{data.data(), width, height, pitch, DXGI_FORMAT_B8G8R8A8_UNORM, 1};
+
+    CHECK_EQ(get_alpha_coverage(view, 1), 0.25f);
+    CHECK_EQ(get_alpha_coverage(view, 2), 0.25f);
+
+    view.format = DXGI_FORMAT_UNKNOWN;
+    CHECK(!get_alpha_coverage(view));
+}
+
+int main() {
+    return test::run_all();
+}
@@ -0,0 +1,170 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "PresetTuner.hpp"
+
+#include "Test.hpp"
+
+namespace {
+// Frame times for a configuration: a base cost plus what each cvar's level adds, some noise on top
+struct CostModel {
+    float base_ms{6.0f};
+    std::vector<std::vector<float>> level_ms{};
+
+    PresetTuner::Sample sample(const std::vector<uint32_t>& levels, uint32_t frame) const {
+        auto ms = base_ms;
+
+        for (size_t i = 0; i < levels.size(); ++i) {
+            ms += level_ms[i][levels[i]];
+        }
+
+        const auto noise = (float)((frame * 7919u) % 11u) * 0.02f - 0.1f;
+        return {ms + noise, ms - noise};
+    }
+};
+
+// Replays the model through the tuner the way the plugin does, one sample per engine tick
+std::vector<uint32_t> replay(PresetTuner& tuner, const CostModel& model, uint32_t& frames) {
+    frames = 0;
+
+    while (tuner.is_running() && frames < 100000) {
+        tuner.add_sample(model.sample(tuner.get_levels(), frames++));
+    }
+
+    return tuner.get_levels();
+}
+
+std::vector<PresetTuner::Dimension> make_space() {
+    return {
+        {L"r.Shadow.MaxResolution", {L"512", L"1024", L"2048"}},
+        {L"r.ScreenPercentage", {L"70", L"85", L"100"}},
+        {L"sg.PostProcessQuality", {L"0", L"1", L"2", L"3"}},
+    };
+}
+
+PresetTuner::Config make_config() {
+    PresetTuner::Config config{};
+    config.target_ms = 11.111f;
+    config.warmup_samples = 10;
+    config.measure_samples = 30;
+    return config;
+}
+}
+
+TEST_CASE(finds_the_best_configuration_under_the_target) {
+    CostModel model{};
+    model.level_ms = {{0.0f, 0.5f, 1.5f}, {0.0f, 1.5f, 3.0f}, {0.0f, 0.2f, 0.4f, 2.5f}};
+
+    PresetTuner tuner{};
+    tuner.start(make_space(), make_config());
+
+    uint32_t frames{};
+    const auto levels = replay(tuner, model, frames);
+
+    // 6 + 1.5 + 3.0 + 0.4 = 10.9ms, the last post processing step (+2.1) goes over
+    CHECK(tuner.get_state() == PresetTuner::State::Done);
+    CHECK_EQ(levels[0], 2u);
+    CHECK_EQ(levels[1], 2u);
+    CHECK_EQ(levels[2], 2u);
+
+    const auto& stats = tuner.get_stats();
+    CHECK_EQ(stats.measured, stats.trials);
+    CHECK_EQ(stats.accepted, 6u);
+    CHECK_EQ(stats.rejected, 1u);
+    CHECK_EQ(stats.accepted + stats.rejected + 1, stats.measured);
+    CHECK_EQ(frames, stats.trials * 40u);
+
+    const auto preset = tuner.get_preset(L"tuned");
+    CHECK(preset.name == L"tuned");
+    CHECK_EQ(preset.values.size(), 3u);
+    CHECK(preset.values[0].value == L"2048");
+    CHECK(preset.values[1].value == L"100");
+    CHECK(preset.values[2].value == L"2");
+}
+
+TEST_CASE(replays_the_same_way_twice) {
+    CostModel model{};
+    model.level_ms = {{0.0f, 1.0f, 2.0f}, {0.0f, 1.0f, 2.0f}, {0.0f, 1.0f, 2.0f, 3.0f}};
+
+    PresetTuner a{};
+    PresetTuner b{};
+    a.start(make_space(), make_config());
+    b.start(make_space(), make_config());
+
+    uint32_t frames_a{};
+    uint32_t frames_b{};
+    CHECK(replay(a, model, frames_a) == replay(b, model, frames_b));
+    CHECK_EQ(frames_a, frames_b);
+    CHECK_EQ(a.get_stats().rejected, b.get_stats().rejected);
+}
+
+TEST_CASE(keeps_the_lowest_configuration_when_nothing_fits) {
+    CostModel model{};
+    model.base_ms = 20.0f;
+    model.level_ms = {{0.0f, 1.0f, 2.0f}, {0.0f, 1.0f, 2.0f}, {0.0f, 1.0f, 2.0f, 3.0f}};
+
+    PresetTuner tuner{};
+    tuner.start(make_space(), make_config());
+
+    uint32_t frames{};
+    const auto levels = replay(tuner, model, frames);
+
+    CHECK(levels == std::vector<uint32_t>(3, 0));
+    CHECK_EQ(tuner.get_stats().accepted, 0u);
+    CHECK_EQ(tuner.get_stats().rejected, 3u);
+}
+
+TEST_CASE(hitches_and_restarts_dont_count) {
+    PresetTuner tuner{};
+    tuner.start(make_space(), make_config());
+
+    // Loading screen
+    for (uint32_t i = 0; i < 100; ++i) {
+        CHECK(!tuner.add_sample({500.0f, 500.0f}));
+    }
+
+    for (uint32_t i = 0; i < 39; ++i) {
+        CHECK(!tuner.add_sample({8.0f, 8.0f}));
+    }
+
+    // The HMD went away right before the trial ended, it runs again in full
+    tuner.restart_trial();
+
+    for (uint32_t i = 0; i < 39; ++i) {
+        CHECK(!tuner.add_sample({8.0f, 8.0f}));
+    }
+
+    CHECK_EQ(tuner.get_stats().measured, 0u);
+    CHECK(tuner.add_sample({8.0f, 8.0f}));
+    CHECK_EQ(tuner.get_stats().measured, 1u);
+    CHECK_EQ(tuner.get_stats().trials, 2u);
+}
+
+TEST_CASE(loads_the_search_space) {
+    const auto path = std::filesystem::temp_directory_path() / "ff7r_tuning_test.txt";
+
+    {
+        std::ofstream file{path};
+        file << "# shadows first\n";
+        file << "r.Shadow.MaxResolution 512 1024 2048\n";
+        file << "\n";
+        file << "; no values, skipped\n";
+        file << "r.Empty\n";
+        file << "r.ScreenPercentage\t70 100\n";
+    }
+
+    const auto space = PresetTuner::load_space(path);
+    std::filesystem::remove(path);
+
+    CHECK_EQ(space.size(), 2u);
+    CHECK(space[0].name == L"r.Shadow.MaxResolution");
+    CHECK_EQ(space[0].values.size(), 3u);
+    CHECK(space[1].values[1] == L"100");
+}
+
+int main() {
+    return test::run_all();
+}
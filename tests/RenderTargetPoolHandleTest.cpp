@@ -0,0 +1,84 @@
+#include "FakeUEVR.hpp"
+
+#include "Test.hpp"
+
+namespace {
+using uevr::API;
+
+int g_rt_a{};
+int g_rt_b{};
+UEVR_IPooledRenderTargetHandle g_pool_rt{nullptr};
+uint32_t g_activations{0};
+uint32_t g_lookups{0};
+
+void install() {
+    [[maybe_unused]] static const bool installed = [] {
+        auto& uevr = fake::get();
+        uevr.render_target_pool_hook.activate = []() { ++g_activations; };
+        uevr.render_target_pool_hook.get_render_target = [](const wchar_t*) { ++g_lookups; return g_pool_rt; };
+        uevr.install();
+        return true;
+    }();
+}
+
+void set_pool(int* rt) {
+    g_pool_rt = (UEVR_IPooledRenderTargetHandle)rt;
+}
+
+API::IPooledRenderTarget* as_rt(int* rt) {
+    return (API::IPooledRenderTarget*)rt;
+}
+}
+
+TEST_CASE(asks_the_pool_every_call) {
+    install();
+    set_pool(&g_rt_a);
+
+    auto handle = API::RenderTargetPoolHook::register_render_target(L"InGameUIRenderTarget");
+    const auto lookups = g_lookups;
+
+    for (uint32_t i = 0; i < 100; ++i) {
+        CHECK_EQ(handle.get(), as_rt(&g_rt_a));
+    }
+
+    CHECK_EQ(g_lookups, lookups + 100);
+    CHECK_EQ(handle.get_generation(), 1u);
+    CHECK_EQ(g_activations, 1u);
+}
+
+TEST_CASE(reallocation_is_seen_on_the_next_call) {
+    install();
+    set_pool(&g_rt_a);
+
+    auto handle = API::RenderTargetPoolHook::register_render_target(L"InGameUIRenderTarget");
+    handle.get();
+
+    // Nobody tells us the pool recycled it, the next call hands out the new one anyway
+    set_pool(&g_rt_b);
+    CHECK_EQ(handle.get(), as_rt(&g_rt_b));
+    CHECK_EQ(handle.get_cached(), as_rt(&g_rt_b));
+    CHECK_EQ(handle.get_generation(), 2u);
+
+    set_pool(nullptr);
+    CHECK_EQ(handle.get(), nullptr);
+    CHECK_EQ(handle.get_generation(), 2u);
+}
+
+TEST_CASE(same_target_after_a_gap_is_not_a_new_generation) {
+    install();
+    set_pool(&g_rt_a);
+
+    auto handle = API::RenderTargetPoolHook::register_render_target(L"InGameUIRenderTarget");
+    handle.get();
+
+    set_pool(nullptr);
+    CHECK_EQ(handle.get(), nullptr);
+
+    set_pool(&g_rt_a);
+    CHECK_EQ(handle.get(), as_rt(&g_rt_a));
+    CHECK_EQ(handle.get_generation(), 1u);
+}
+
+int main() {
+    return test::run_all();
+}
@@ -0,0 +1,88 @@
+#include "ResolutionPublisher.hpp"
+
+#include "Test.hpp"
+
+namespace {
+using Size = ResolutionPublisher::Size;
+
+constexpr Size FULL{4032, 2240};
+constexpr Size SMALL{3344, 1856};
+constexpr Size ENGINE{1920, 1080};
+}
+
+TEST_CASE(publishes_once_settled) {
+    ResolutionPublisher publisher{};
+    publisher.set_config({5});
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        CHECK(!publisher.update(FULL, ENGINE));
+    }
+
+    const auto publish = publisher.update(FULL, ENGINE);
+    CHECK(publish && *publish == FULL);
+    CHECK_EQ(publisher.get_reasserts_since_publish(), 0u);
+
+    // Nothing to write while memory agrees
+    CHECK(!publisher.update(FULL, FULL));
+    CHECK_EQ(publisher.get_stats().publishes, 1u);
+}
+
+TEST_CASE(runs_of_changes_coalesce) {
+    ResolutionPublisher publisher{};
+    publisher.set_config({5});
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        CHECK(!publisher.update(FULL, ENGINE));
+        CHECK(!publisher.update(SMALL, ENGINE));
+    }
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        publisher.update(SMALL, ENGINE);
+    }
+
+    CHECK(publisher.get_published() && *publisher.get_published() == SMALL);
+    CHECK_EQ(publisher.get_stats().publishes, 1u);
+    CHECK(publisher.get_stats().coalesced >= 5u);
+}
+
+TEST_CASE(rewrites_are_counted_per_publish) {
+    ResolutionPublisher publisher{};
+    publisher.set_config({1});
+
+    publisher.update(FULL, ENGINE);
+
+    // Something keeps writing its own value back every frame
+    for (uint32_t i = 1; i <= 100; ++i) {
+        const auto publish = publisher.update(FULL, ENGINE);
+        CHECK(publish && *publish == FULL);
+        CHECK_EQ(publisher.get_reasserts_since_publish(), i);
+    }
+
+    CHECK_EQ(publisher.get_stats().reasserts, 100u);
+
+    // A new size starts the count over
+    publisher.update(SMALL, FULL);
+    CHECK_EQ(publisher.get_reasserts_since_publish(), 0u);
+    CHECK_EQ(publisher.get_stats().publishes, 2u);
+}
+
+TEST_CASE(keeps_the_old_size_while_a_new_one_settles) {
+    ResolutionPublisher publisher{};
+    publisher.set_config({3});
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        publisher.update(FULL, FULL);
+    }
+
+    const auto publish = publisher.update(SMALL, ENGINE);
+    CHECK(publish && *publish == FULL);
+    CHECK_EQ(publisher.get_reasserts_since_publish(), 1u);
+
+    publisher.reset();
+    CHECK(!publisher.get_published());
+    CHECK_EQ(publisher.get_reasserts_since_publish(), 0u);
+}
+
+int main() {
+    return test::run_all();
+}
@@ -0,0 +1,59 @@
+#include <string>
+
+#include "FakeUEVR.hpp"
+#include "Test.hpp"
+
+namespace {
+using uevr::API;
+
+int g_object_class{};
+int g_struct_class{};
+bool g_loaded{false};
+uint32_t g_lookups{0};
+
+void install() {
+    [[maybe_unused]] static const bool installed = [] {
+        auto& uevr = fake::get();
+        uevr.uobject_array.find_uobject = [](const wchar_t* name) {
+            ++g_lookups;
+
+            if (!g_loaded) {
+                return (UEVR_UObjectHandle)nullptr;
+            }
+
+            const std::wstring_view path{name};
+            return (UEVR_UObjectHandle)(path == L"Class /Script/CoreUObject.Object" ? &g_object_class : &g_struct_class);
+        };
+        uevr.install();
+        return true;
+    }();
+}
+}
+
+// One case, the helpers keep what they found for the life of the process
+TEST_CASE(found_once_then_kept_missing_is_retried) {
+    install();
+
+    // Too early, nothing is loaded yet and nothing gets remembered
+    CHECK(API::UObject::static_class() == nullptr);
+    CHECK(API::UObject::static_class() == nullptr);
+    CHECK_EQ(g_lookups, 2u);
+
+    g_loaded = true;
+    CHECK(API::UObject::static_class() == (API::UClass*)&g_object_class);
+    CHECK_EQ(g_lookups, 3u);
+
+    for (uint32_t i = 0; i < 100; ++i) {
+        CHECK(API::UObject::static_class() == (API::UClass*)&g_object_class);
+    }
+
+    CHECK_EQ(g_lookups, 3u);
+
+    // Every helper has its own
+    CHECK(API::UStruct::static_class() == (API::UClass*)&g_struct_class);
+    CHECK_EQ(g_lookups, 4u);
+}
+
+int main() {
+    return test::run_all();
+}
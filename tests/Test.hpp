@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+// Bare minimum test runner, every test file is its own executable:
+//   TEST_CASE(clears_once) { CHECK(...); CHECK_EQ(a, b); }
+//   int main() { return test::run_all(); }
+namespace test {
+struct Case {
+    const char* name;
+    void (*fn)();
+};
+
+inline std::vector<Case>& get_cases() {
+    static std::vector<Case> cases{};
+    return cases;
+}
+
+inline int& get_failures() {
+    static int failures{0};
+    return failures;
+}
+
+struct Register {
+    Register(const char* name, void (*fn)()) {
+        get_cases().push_back(Case{name, fn});
+    }
+};
+
+inline void fail(const char* file, int line, const char* expr) {
+    std::printf("%s:%d: CHECK(%s) failed\n", file, line, expr);
+    ++get_failures();
+}
+
+inline int run_all() {
+    int failed_cases = 0;
+
+    for (const auto& c : get_cases()) {
+        const auto before = get_failures();
+        c.fn();
+
+        const auto ok = get_failures() == before;
+        failed_cases += ok ? 0 : 1;
+        std::printf("[%s] %s\n", ok ? "PASS" : "FAIL", c.name);
+    }
+
+    std::printf("%d/%d passed\n", (int)get_cases().size() - failed_cases, (int)get_cases().size());
+    return failed_cases == 0 ? 0 : 1;
+}
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static const test::Register name##_register{#name, &name}; \
+    static void name()
+
+#define CHECK(expr) \
+    do { \
+        if (!(expr)) { \
+            test::fail(__FILE__, __LINE__, #expr); \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) CHECK((a) == (b))
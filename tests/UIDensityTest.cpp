@@ -0,0 +1,130 @@
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+#include "UIDensity.hpp"
+
+#include "Test.hpp"
+
+namespace {
+// 100 degrees horizontal, 104 vertical, symmetric
+UIDensity::Input headset_input() {
+    UIDensity::Input input{};
+    input.projection_x_scale = 1.0f / std::tan(50.0f * 3.14159265f / 180.0f);
+    input.projection_y_scale = 1.0f / std::tan(52.0f * 3.14159265f / 180.0f);
+    input.eye_width = 2016;
+    input.eye_height = 2240;
+    input.ui_width = 1920;
+    input.ui_height = 1080;
+    return input;
+}
+
+bool near(float a, float b, float tolerance) {
+    return std::abs(a - b) <= tolerance;
+}
+}
+
+TEST_CASE(matches_hand_computed_density) {
+    const auto result = UIDensity::compute(headset_input());
+
+    CHECK(result.has_value());
+    // 2016 / 2 * (1 / tan 50) px per unit of tangent, over 57.3 deg per radian
+    CHECK(near(result->pixels_per_degree_x, 14.76f, 0.01f));
+    // 2 m wide at 2 m is 2 * atan(0.5)
+    CHECK(near(result->ui_degrees_x, 53.13f, 0.01f));
+    // The quad is 1.125 m tall: 31.42 deg at 15.27 px/deg is 480 of 1080, more than the 784 of 1920 across
+    CHECK(near(result->pixels_per_degree_y, 15.27f, 0.01f));
+    CHECK(near(result->ui_degrees_y, 31.42f, 0.01f));
+    CHECK(near(result->scale, 479.81f / 1080.0f, 0.001f));
+    CHECK_EQ(result->width, 854u);
+    CHECK_EQ(result->height, 480u);
+}
+
+TEST_CASE(sizes_are_even_and_within_the_ui_target) {
+    for (const auto distance : {0.25f, 0.5f, 1.0f, 1.7f, 2.0f, 3.3f, 8.0f}) {
+        auto input = headset_input();
+        input.placement.distance = distance;
+
+        const auto result = UIDensity::compute(input);
+
+        CHECK(result.has_value());
+        CHECK_EQ(result->width % 2, 0u);
+        CHECK_EQ(result->height % 2, 0u);
+        CHECK(result->width <= input.ui_width);
+        CHECK(result->height <= input.ui_height);
+        CHECK(result->scale >= input.min_scale && result->scale <= 1.0f);
+    }
+}
+
+TEST_CASE(farther_ui_needs_fewer_pixels) {
+    auto near_input = headset_input();
+    near_input.placement.distance = 1.5f;
+    auto far_input = headset_input();
+    far_input.placement.distance = 3.0f;
+
+    const auto near_result = UIDensity::compute(near_input);
+    const auto far_result = UIDensity::compute(far_input);
+
+    CHECK(near_result.has_value() && far_result.has_value());
+    CHECK(far_result->scale < near_result->scale);
+    CHECK(far_result->width < near_result->width);
+}
+
+TEST_CASE(clamps_to_min_scale_and_the_full_target) {
+    auto tiny = headset_input();
+    tiny.placement.distance = 100.0f;
+    const auto tiny_result = UIDensity::compute(tiny);
+
+    CHECK(tiny_result.has_value());
+    CHECK_EQ(tiny_result->scale, tiny.min_scale);
+    CHECK_EQ(tiny_result->width, 480u);
+    CHECK_EQ(tiny_result->height, 270u);
+
+    auto huge = headset_input();
+    huge.oversample = 4.0f;
+    const auto huge_result = UIDensity::compute(huge);
+
+    CHECK(huge_result.has_value());
+    CHECK_EQ(huge_result->scale, 1.0f);
+    CHECK_EQ(huge_result->width, huge.ui_width);
+    CHECK_EQ(huge_result->height, huge.ui_height);
+}
+
+TEST_CASE(rejects_unusable_input) {
+    auto no_eye = headset_input();
+    no_eye.eye_width = 0;
+    CHECK(!UIDensity::compute(no_eye).has_value());
+
+    auto no_ui = headset_input();
+    no_ui.ui_height = 0;
+    CHECK(!UIDensity::compute(no_ui).has_value());
+
+    auto no_projection = headset_input();
+    no_projection.projection_y_scale = 0.0f;
+    CHECK(!UIDensity::compute(no_projection).has_value());
+
+    auto behind = headset_input();
+    behind.placement.distance = -1.0f;
+    CHECK(!UIDensity::compute(behind).has_value());
+}
+
+TEST_CASE(loads_placement_from_uevr_config) {
+    const auto path = std::filesystem::temp_directory_path() / "ff7r_uevr_config_test.txt";
+    std::ofstream{path} << "UI_Size=2.750000\n"
+                           "UI_Distance=not a number\n"
+                           "Frontend_RequestedRuntime=openxr_loader.dll\n"
+                           "no equals sign\n";
+
+    const auto placement = UIPlacement::load(path);
+    std::filesystem::remove(path);
+
+    CHECK(placement.has_value());
+    CHECK_EQ(placement->size, 2.75f);
+    CHECK_EQ(placement->distance, UIPlacement{}.distance);
+
+    CHECK(!UIPlacement::load(path).has_value());
+}
+
+int main() {
+    return test::run_all();
+}
@@ -0,0 +1,217 @@
+#include <optional>
+
+#include "Renderer.hpp"
+#include "UIPresentWork.hpp"
+
+#include "Test.hpp"
+
+namespace {
+using NullRenderer = Renderer<RendererType::Null>;
+
+int g_engine_tex{};
+int g_ui_tex{};
+
+void* engine_tex() { return &g_engine_tex; }
+void* ui_tex() { return &g_ui_tex; }
+
+UIAlphaResult probe_result(uint64_t frame, uint64_t coverage) {
+    UIAlphaResult out{};
+    out.frame = frame;
+    out.texture = engine_tex();
+    out.coverage = coverage;
+    out.empty = coverage == 0;
+    return out;
+}
+
+// One present the way the plugin drives it
+UIPresentWork::Result present(UIPresentWork& work, NullRenderer& renderer, const UIPresentWork::Targets& targets, uint32_t frame) {
+    renderer.begin_frame();
+    const auto result = work.run(renderer, targets, frame);
+    renderer.end_frame();
+    return result;
+}
+}
+
+TEST_CASE(clears_only_what_was_asked_for) {
+    NullRenderer renderer{};
+    UIPresentWork work{};
+
+    CHECK(!present(work, renderer, {}, 1).cleared);
+    CHECK(present(work, renderer, {engine_tex(), nullptr, nullptr}, 2).cleared);
+    CHECK(!present(work, renderer, {}, 3).cleared);
+
+    CHECK_EQ(renderer.frames, 3u);
+    CHECK_EQ(renderer.clears, 1u);
+    CHECK_EQ(renderer.rect_clears, 0u);
+}
+
+TEST_CASE(snapshots_and_probes_follow_the_config) {
+    NullRenderer renderer{};
+    UIPresentWork work{};
+    const UIPresentWork::Targets targets{nullptr, ui_tex(), engine_tex()};
+
+    present(work, renderer, targets, 1);
+    CHECK_EQ(renderer.snapshots, 0u);
+    CHECK_EQ(renderer.probes, 0u);
+
+    work.set_config({true, false});
+    present(work, renderer, targets, 2);
+    present(work, renderer, {}, 3); // no UI render target yet
+    CHECK_EQ(renderer.snapshots, 1u);
+    CHECK_EQ(renderer.probes, 0u);
+
+    work.set_config({false, true});
+    present(work, renderer, targets, 4);
+    CHECK_EQ(renderer.snapshots, 1u);
+    CHECK_EQ(renderer.probes, 1u);
+}
+
+TEST_CASE(stable_probe_results_switch_the_clear_to_rects) {
+    NullRenderer renderer{};
+    UIPresentWork work{};
+    work.set_config({false, true});
+
+    uint32_t frame = 0;
+
+    // Coverage that keeps growing is never trusted
+    for (uint32_t i = 0; i < 20; ++i) {
+        renderer.probe_result = probe_result(++frame, 1ull << i);
+        present(work, renderer, {nullptr, nullptr, engine_tex()}, frame);
+    }
+
+    // The swap points the engine at UEVR's UI render target and asks for its own texture to be cleared
+    present(work, renderer, {engine_tex(), nullptr, ui_tex()}, ++frame);
+    CHECK_EQ(renderer.clears, 1u);
+    CHECK_EQ(renderer.rect_clears, 0u);
+
+    // The clear starts the coverage over, the same coverage for long enough is trusted
+    for (uint32_t i = 0; i < 12; ++i) {
+        renderer.probe_result = probe_result(++frame, 0xFFull);
+        present(work, renderer, {nullptr, nullptr, engine_tex()}, frame);
+    }
+
+    present(work, renderer, {engine_tex(), nullptr, ui_tex()}, ++frame);
+    CHECK_EQ(renderer.clears, 2u);
+    CHECK_EQ(renderer.rect_clears, 1u);
+}
+
+TEST_CASE(lagging_probe_falls_back_to_a_full_clear) {
+    NullRenderer renderer{};
+    UIPresentWork work{};
+    work.set_config({false, true});
+
+    constexpr uint32_t LAG = 3;
+    const UIPresentWork::Targets drawing{nullptr, nullptr, engine_tex()};
+    const UIPresentWork::Targets swapped{engine_tex(), nullptr, ui_tex()};
+    uint32_t frame = 0;
+
+    // Stable and empty as far as the probe can tell, but it's a few frames behind the draws
+    for (uint32_t i = 0; i < 20; ++i) {
+        ++frame;
+        renderer.probe_result = frame > LAG ? std::optional{probe_result(frame - LAG, 0)} : std::nullopt;
+        present(work, renderer, drawing, frame);
+    }
+
+    CHECK(work.get_dirty().is_empty(engine_tex()));
+
+    // The UI drawn in the last frames before the swap was never probed
+    auto result = present(work, renderer, swapped, ++frame);
+    CHECK(result.cleared);
+    CHECK(result.probe_stale);
+    CHECK(!result.clear_skipped);
+    CHECK_EQ(renderer.clears, 1u);
+    CHECK_EQ(renderer.rect_clears, 0u);
+
+    // Same for rects, UI that just appeared isn't in the coverage yet
+    for (uint32_t i = 0; i < 20; ++i) {
+        ++frame;
+        renderer.probe_result = probe_result(frame - LAG, 0x3ull);
+        present(work, renderer, drawing, frame);
+    }
+
+    result = present(work, renderer, swapped, ++frame);
+    CHECK(result.probe_stale);
+    CHECK_EQ(renderer.clears, 2u);
+    CHECK_EQ(renderer.rect_clears, 0u);
+
+    // Once the probe has caught up with the last draw its results count again
+    for (uint32_t i = 0; i < 20; ++i) {
+        ++frame;
+        renderer.probe_result = probe_result(frame - LAG, 0);
+        present(work, renderer, drawing, frame);
+    }
+
+    const auto last_draw = frame;
+
+    for (uint32_t i = LAG; i > 0; --i) {
+        renderer.probe_result = probe_result(last_draw - i + 1, 0);
+        present(work, renderer, {nullptr, nullptr, ui_tex()}, ++frame);
+    }
+
+    result = present(work, renderer, swapped, ++frame);
+    CHECK(result.clear_skipped);
+    CHECK(!result.probe_stale);
+    CHECK_EQ(renderer.clears, 2u);
+    CHECK_EQ(work.get_skipped_clears(), 1u);
+}
+
+TEST_CASE(texture_probed_empty_is_not_cleared) {
+    NullRenderer renderer{};
+    UIPresentWork work{};
+    const UIPresentWork::Targets clear{engine_tex(), nullptr, nullptr};
+
+    // Without the probe there's nothing to go on
+    present(work, renderer, clear, 1);
+    CHECK_EQ(renderer.clears, 1u);
+
+    work.set_config({false, true});
+    uint32_t frame = 1;
+
+    // A few empty results aren't enough yet
+    for (uint32_t i = 0; i < 3; ++i) {
+        renderer.probe_result = probe_result(++frame, 0);
+        present(work, renderer, {nullptr, nullptr, engine_tex()}, frame);
+    }
+
+    CHECK(present(work, renderer, clear, ++frame).cleared);
+    CHECK_EQ(renderer.clears, 2u);
+
+    for (uint32_t i = 0; i < 12; ++i) {
+        renderer.probe_result = probe_result(++frame, 0);
+        present(work, renderer, {nullptr, nullptr, engine_tex()}, frame);
+    }
+
+    const auto result = present(work, renderer, clear, ++frame);
+    CHECK(result.clear_skipped);
+    CHECK(!result.cleared);
+    CHECK_EQ(renderer.clears, 2u);
+    CHECK_EQ(work.get_skipped_clears(), 1u);
+
+    // Skipping starts the coverage over just like a clear
+    CHECK(present(work, renderer, clear, ++frame).cleared);
+}
+
+TEST_CASE(reports_empty_transitions) {
+    NullRenderer renderer{};
+    UIPresentWork work{};
+    work.set_config({false, true});
+
+    renderer.probe_result = probe_result(1, 0);
+    CHECK(!present(work, renderer, {}, 1).empty_changed);
+
+    renderer.probe_result = probe_result(2, 0);
+    CHECK(!present(work, renderer, {}, 2).empty_changed);
+
+    renderer.probe_result = probe_result(3, 0x10);
+    CHECK(present(work, renderer, {}, 3).empty_changed);
+
+    const auto& stats = work.get_empty_stats();
+    CHECK_EQ(stats.probes, 3u);
+    CHECK_EQ(stats.empty, 2u);
+    CHECK_EQ(stats.transitions, 1u);
+    CHECK(stats.latest && !stats.latest->empty);
+}
+
+int main() {
+    return test::run_all();
+}
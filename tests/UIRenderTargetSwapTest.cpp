@@ -0,0 +1,126 @@
+#include "UIRenderTargetSwap.hpp"
+
+#include "Test.hpp"
+
+namespace {
+// Never dereferenced, only the addresses matter
+struct Texture {
+    int id;
+};
+
+using Swap = UIRenderTargetSwap<Texture>;
+}
+
+TEST_CASE(swaps_in_and_clears_once) {
+    Texture engine{1}, engine_srt{2}, ui{3};
+    Swap swap{};
+
+    auto result = swap.update(&engine, &engine_srt, &ui, true);
+    CHECK_EQ(result.texture, &ui);
+    CHECK_EQ(result.clear, &engine);
+    CHECK(swap.get_state() == Swap::State::Swapped);
+    CHECK_EQ(swap.get_engine_texture(), &engine);
+    CHECK_EQ(swap.get_engine_srt(), &engine_srt);
+
+    // Pooled target already points at ours from here on
+    result = swap.update(&ui, &engine_srt, &ui, true);
+    CHECK_EQ(result.texture, &ui);
+    CHECK_EQ(result.clear, nullptr);
+    CHECK_EQ(swap.get_stats().clears, 1u);
+}
+
+TEST_CASE(nothing_happens_without_hmd) {
+    Texture engine{1}, ui{3};
+    Swap swap{};
+
+    const auto result = swap.update(&engine, nullptr, &ui, false);
+    CHECK_EQ(result.texture, &engine);
+    CHECK_EQ(result.clear, nullptr);
+    CHECK(swap.get_state() == Swap::State::Inactive);
+
+    CHECK_EQ(swap.update(&engine, nullptr, nullptr, true).texture, &engine);
+    CHECK_EQ(swap.get_stats().swaps, 0u);
+}
+
+TEST_CASE(restores_engine_texture) {
+    Texture engine{1}, ui{3};
+    Swap swap{};
+
+    swap.update(&engine, nullptr, &ui, true);
+
+    const auto result = swap.update(&ui, nullptr, &ui, false);
+    CHECK_EQ(result.texture, &engine);
+    CHECK_EQ(result.clear, nullptr);
+    CHECK(swap.get_state() == Swap::State::Inactive);
+    CHECK_EQ(swap.get_stats().restores, 1u);
+
+    // A new session clears again, the engine drew into its texture in between
+    CHECK_EQ(swap.update(&engine, nullptr, &ui, true).clear, &engine);
+    CHECK_EQ(swap.get_stats().clears, 2u);
+}
+
+TEST_CASE(follows_ui_target_reallocation) {
+    Texture engine{1}, ui{3}, ui2{4};
+    Swap swap{};
+
+    swap.update(&engine, nullptr, &ui, true);
+
+    const auto result = swap.update(&ui, nullptr, &ui2, true);
+    CHECK_EQ(result.texture, &ui2);
+    CHECK_EQ(result.clear, nullptr);
+    CHECK_EQ(swap.get_stats().retargets, 1u);
+    CHECK_EQ(swap.get_engine_texture(), &engine);
+}
+
+TEST_CASE(same_texture_handed_back_is_not_cleared_twice) {
+    Texture engine{1}, ui{3};
+    Swap swap{};
+
+    swap.update(&engine, nullptr, &ui, true);
+
+    // Engine put its own texture back into the pooled target without drawing into it
+    const auto result = swap.update(&engine, nullptr, &ui, true);
+    CHECK_EQ(result.texture, &ui);
+    CHECK_EQ(result.clear, nullptr);
+    CHECK_EQ(swap.get_stats().reallocations, 1u);
+    CHECK_EQ(swap.get_stats().clears_skipped, 1u);
+}
+
+TEST_CASE(pooled_texture_reused_elsewhere_is_cleared_again) {
+    Texture a{1}, b{2}, ui{3};
+    Swap swap{};
+
+    CHECK_EQ(swap.update(&a, nullptr, &ui, true).clear, &a);
+
+    // The pool hands us b, a goes to some other target and gets drawn into
+    CHECK_EQ(swap.update(&b, nullptr, &ui, true).clear, &b);
+
+    // a comes back with the other target's contents in it
+    const auto result = swap.update(&a, nullptr, &ui, true);
+    CHECK_EQ(result.texture, &ui);
+    CHECK_EQ(result.clear, &a);
+    CHECK_EQ(swap.get_engine_texture(), &a);
+    CHECK_EQ(swap.get_stats().clears, 3u);
+    CHECK_EQ(swap.get_stats().clears_skipped, 0u);
+}
+
+TEST_CASE(missing_target_drops_the_session) {
+    Texture engine{1}, ui{3};
+    Swap swap{};
+
+    swap.update(&engine, nullptr, &ui, true);
+    swap.on_target_missing();
+
+    CHECK(swap.get_state() == Swap::State::Inactive);
+    CHECK_EQ(swap.get_engine_texture(), nullptr);
+
+    // Pooled target came back still pointing at ours, there's nothing to restore into
+    const auto result = swap.update(&ui, nullptr, &ui, true);
+    CHECK_EQ(result.texture, &ui);
+    CHECK_EQ(result.clear, nullptr);
+    CHECK(swap.get_state() == Swap::State::Inactive);
+}
+
+int main() {
+    return test::run_all();
+}